@@ -0,0 +1,188 @@
+#include "virtual_audio_device.h"
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NS_PER_S 1000000000LL
+
+typedef struct {
+    const VirtualAudioConfig* config;
+    VirtualAudioCallback callback;
+    VirtualAudioStats* stats;
+    float* in[VIRTUAL_AUDIO_CHANNELS];
+    float* out[VIRTUAL_AUDIO_CHANNELS];
+    double phase;
+    uint64_t sample;
+    uint32_t noise;
+} VirtualAudioRun;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+static struct timespec to_timespec(int64_t ns) {
+    struct timespec ts = {(time_t)(ns / NS_PER_S), (long)(ns % NS_PER_S)};
+    return ts;
+}
+
+// Fill the input channels with the configured test signal
+static void generate_input(VirtualAudioRun* run) {
+    const VirtualAudioConfig* config = run->config;
+    double inc = config->frequency / config->sample_rate;
+    uint64_t impulse_period = config->frequency > 0.f ? (uint64_t)(config->sample_rate / config->frequency) : 0;
+
+    for (uint32_t i = 0; i < config->block_size; i++, run->sample++) {
+        float value = 0.f;
+        switch (config->input) {
+            case VIRTUAL_INPUT_SILENCE:
+                break;
+            case VIRTUAL_INPUT_SINE:
+                value = config->amplitude * (float)sin(2.0 * M_PI * run->phase);
+                run->phase += inc;
+                if (run->phase >= 1.0) run->phase -= 1.0;
+                break;
+            case VIRTUAL_INPUT_NOISE:
+                // xorshift32, deterministic across runs
+                run->noise ^= run->noise << 13;
+                run->noise ^= run->noise >> 17;
+                run->noise ^= run->noise << 5;
+                value = config->amplitude * ((float)run->noise / 4294967295.f * 2.f - 1.f);
+                break;
+            case VIRTUAL_INPUT_IMPULSE:
+                if (impulse_period && run->sample % impulse_period == 0) value = config->amplitude;
+                break;
+        }
+        for (int c = 0; c < VIRTUAL_AUDIO_CHANNELS; c++) run->in[c][i] = value;
+    }
+}
+
+// Start of block b relative to the epoch, exact at any rate: a period that isn't a
+// whole number of nanoseconds (128 samples @ 44.1 kHz) must not drift over a long run
+static int64_t block_offset_ns(const VirtualAudioConfig* config, uint64_t b) {
+    return (int64_t)(b * config->block_size * (uint64_t)NS_PER_S / config->sample_rate);
+}
+
+static void* device_thread(void* arg) {
+    VirtualAudioRun* run = (VirtualAudioRun*)arg;
+    const VirtualAudioConfig* config = run->config;
+    VirtualAudioStats* stats = run->stats;
+
+    double period_ns = (double)config->block_size * NS_PER_S / config->sample_rate;
+    double jitter_sum = 0.0;
+    double process_sum = 0.0;
+    double load_sum = 0.0;
+
+    stats->jitter_min_ns = INT64_MAX;
+    stats->jitter_max_ns = INT64_MIN;
+    stats->margin_min_ns = INT64_MAX;
+
+    // Blocks are due on a fixed grid; a late block does not shift the ones after it
+    int64_t epoch = now_ns() + block_offset_ns(config, 1);
+    for (uint32_t b = 0; b < config->num_blocks; b++) {
+        int64_t due = epoch + block_offset_ns(config, b);
+        int64_t deadline = epoch + block_offset_ns(config, b + 1);
+        struct timespec wake = to_timespec(due);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0) {}
+        // Jitter is the wakeup latency, before any of the device's own work
+        int64_t woke = now_ns();
+
+        // Input is generated before the callback, like a completed DMA transfer
+        generate_input(run);
+
+        int64_t start = now_ns();
+        run->callback((const float* const*)run->in, run->out, config->block_size);
+        int64_t end = now_ns();
+
+        int64_t jitter = woke - due;
+        int64_t process = end - start;
+        int64_t margin = deadline - end;
+        double load = (double)process / period_ns;
+
+        stats->blocks++;
+        if (margin < 0) stats->xruns++;
+        if (jitter >= deadline - due) stats->late_starts++;
+        if (jitter < stats->jitter_min_ns) stats->jitter_min_ns = jitter;
+        if (jitter > stats->jitter_max_ns) stats->jitter_max_ns = jitter;
+        if (process > stats->process_max_ns) stats->process_max_ns = process;
+        if (margin < stats->margin_min_ns) stats->margin_min_ns = margin;
+        if (load > stats->load_peak) stats->load_peak = load;
+        jitter_sum += (double)jitter;
+        process_sum += (double)process;
+        load_sum += load;
+    }
+
+    if (stats->blocks) {
+        stats->jitter_mean_ns = jitter_sum / stats->blocks;
+        stats->process_mean_ns = process_sum / stats->blocks;
+        stats->load_mean = load_sum / stats->blocks;
+    }
+    return NULL;
+}
+
+bool virtual_audio_run(const VirtualAudioConfig* config, VirtualAudioCallback callback, VirtualAudioStats* stats) {
+    VirtualAudioRun run = {0};
+    run.config = config;
+    run.callback = callback;
+    run.stats = stats;
+    run.noise = 0x12345678u;
+    memset(stats, 0, sizeof(*stats));
+
+    bool ok = true;
+    for (int c = 0; c < VIRTUAL_AUDIO_CHANNELS && ok; c++) {
+        run.in[c] = calloc(config->block_size, sizeof(float));
+        run.out[c] = calloc(config->block_size, sizeof(float));
+        ok = run.in[c] && run.out[c];
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (ok && config->rt_priority > 0) {
+        struct sched_param param = {.sched_priority = config->rt_priority};
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+        stats->realtime = pthread_create(&thread, &attr, device_thread, &run) == 0;
+        if (!stats->realtime) {
+            // Usually missing CAP_SYS_NICE / rtprio limits: measure anyway, but flag it
+            printf("WARNING: SCHED_FIFO unavailable, running on the default scheduler\n");
+        }
+    }
+    if (ok && !stats->realtime) {
+        ok = pthread_create(&thread, NULL, device_thread, &run) == 0;
+    }
+    pthread_attr_destroy(&attr);
+
+    if (ok) pthread_join(thread, NULL);
+
+    for (int c = 0; c < VIRTUAL_AUDIO_CHANNELS; c++) {
+        free(run.in[c]);
+        free(run.out[c]);
+    }
+    return ok;
+}
+
+void virtual_audio_report(const VirtualAudioConfig* config, const VirtualAudioStats* stats,
+                          WamrWriteLine write_line, void* ctx) {
+    char line[128];
+    double period_us = (double)config->block_size * 1e6 / config->sample_rate;
+
+#define REPORT(...) do { snprintf(line, sizeof(line), __VA_ARGS__); write_line(line, ctx); } while (0)
+    REPORT("=== VIRTUAL AUDIO DEVICE REPORT ===");
+    REPORT("Cadence:  %u samples @ %u Hz (%.1f us period), %s", (unsigned)config->block_size,
+           (unsigned)config->sample_rate, period_us, stats->realtime ? "SCHED_FIFO" : "default scheduler");
+    REPORT("Blocks:   %u", (unsigned)stats->blocks);
+    REPORT("Jitter:   min %.1f / mean %.1f / max %.1f us", stats->jitter_min_ns / 1e3,
+           stats->jitter_mean_ns / 1e3, stats->jitter_max_ns / 1e3);
+    REPORT("Process:  mean %.1f / max %.1f us", stats->process_mean_ns / 1e3, stats->process_max_ns / 1e3);
+    REPORT("Margin:   min %.1f us to deadline", stats->margin_min_ns / 1e3);
+    REPORT("CPU load: mean %.1f%% / peak %.1f%%", stats->load_mean * 100.0, stats->load_peak * 100.0);
+    REPORT("Xruns:    %u (late starts: %u)", (unsigned)stats->xruns, (unsigned)stats->late_starts);
+#undef REPORT
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "wamr_aot_wrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Virtual audio device for the Linux host build. Drives the same callback that
+// libDaisy's SAI DMA would, from a real-time thread at the exact block cadence,
+// and measures how well the callback keeps up.
+
+#define VIRTUAL_AUDIO_CHANNELS 2
+
+// Same shape as daisy::AudioHandle::AudioCallback
+typedef void (*VirtualAudioCallback)(const float* const* in, float** out, size_t size);
+
+typedef enum {
+    VIRTUAL_INPUT_SILENCE = 0,
+    VIRTUAL_INPUT_SINE,
+    VIRTUAL_INPUT_NOISE,
+    VIRTUAL_INPUT_IMPULSE  // one impulse per `frequency` period
+} VirtualInputSignal;
+
+typedef struct {
+    uint32_t sample_rate;  // e.g. 48000
+    uint32_t block_size;   // e.g. BLOCK_SIZE
+    uint32_t num_blocks;   // blocks to run before stopping
+    int rt_priority;       // SCHED_FIFO priority, 0 for the default scheduler
+    VirtualInputSignal input;
+    float frequency;
+    float amplitude;
+} VirtualAudioConfig;
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t xruns;              // callbacks that finished after their block's deadline
+    uint32_t late_starts;        // callbacks that started a whole period late
+    int64_t jitter_min_ns;       // start time relative to the ideal cadence
+    int64_t jitter_max_ns;
+    double jitter_mean_ns;
+    int64_t process_max_ns;
+    double process_mean_ns;
+    int64_t margin_min_ns;       // smallest time left between callback end and deadline
+    double load_mean;            // processing time / block period
+    double load_peak;
+    bool realtime;               // SCHED_FIFO was granted
+} VirtualAudioStats;
+
+/**
+ * Run the callback num_blocks times at the configured cadence on a real-time
+ * thread and block until done. Returns false if the thread couldn't be started.
+ */
+bool virtual_audio_run(const VirtualAudioConfig* config, VirtualAudioCallback callback, VirtualAudioStats* stats);
+
+// Write a latency/CPU-load report through write_line
+void virtual_audio_report(const VirtualAudioConfig* config, const VirtualAudioStats* stats,
+                          WamrWriteLine write_line, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,13 +1,55 @@
 #include "wamr_aot_wrapper.h"
+#include "wamr_log.h"
+#include "wamr_assets.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
+#include "bh_platform.h"
+#include "aot_runtime.h"
+#include "wasm_exec_env.h"
+#include "mem_alloc.h"
 
-// Embedded AOT Module
-#include "../wasm-module/build/module_aot.h"
+// Embedded AOT Module (bounds-checked; trusted builds also embed the unchecked variant),
+// from the build directory of build-wasm.sh for the target being built
+#include "module_aot.h"
+#ifdef WAMR_TRUSTED_MODULES
+#include "module_trusted_aot.h"
+#endif
 
-#define STACK_SIZE 8192
-#define HEAP_SIZE (16 * 1024)  // Match main.cpp heap size
+// Trusted (bounds-check-free) images are tagged with this custom section, and the
+// tag can only be seen if the loader keeps custom sections
+#define TRUSTED_SECTION "wamr.trusted"
+#if WASM_ENABLE_LOAD_CUSTOM_SECTION == 0
+#error "WASM_ENABLE_LOAD_CUSTOM_SECTION is required to reject trusted module images"
+#endif
+#include "../wasm-module/wamr_events.h"
+#include "../wasm-module/wamr_frames.h"
+
+// The app heap is sized from the module's measured memory profile plus a safety
+// margin. Profiling builds use a generous fixed size so the measurement itself
+// can't overflow. The C stack lives in linear memory and is sized at link time.
+#define MEMORY_MARGIN_PERCENT 25
+#define WITH_MARGIN(bytes) (((bytes) * (100 + MEMORY_MARGIN_PERCENT) / 100 + 15) & ~15u)
+#define PROFILE_HEAP_SIZE (64 * 1024)
+
+// Sizes every module got before per-module profiles, used to report the saving:
+// emscripten's default C stack and the old fixed app heap
+#define LEGACY_STACK_SIZE (64 * 1024)
+#define LEGACY_HEAP_SIZE (16 * 1024)
+
+// WAMR's own stack, not profiled per module: AOT code runs on the native stack and
+// only pushes frame records here in perf-profiling or call-stack-dump builds. The
+// interpreter tiers keep their frames here, and only bring-up runs use them.
+#define EXEC_ENV_STACK_SIZE 8192
+#define STACK_PAINT 0xA5
+
+// Default multi-rate schedule in blocks (128 samples @ 48kHz: ~94Hz control, ~6Hz idle)
+#define CONTROL_PERIOD_BLOCKS 4
+#define IDLE_PERIOD_BLOCKS 64
+
+// Consecutive overruns after which the module is bypassed
+#define WAMR_DEADLINE_MAX_STRIKES 8
 
 // Forward declarations for SDRAM allocator functions
 extern void* sdram_alloc(size_t size);
@@ -15,55 +57,474 @@ extern void* sdram_realloc(void* ptr, size_t size);
 extern void sdram_dealloc(void* ptr);
 extern void* sdram_calloc(size_t nmemb, size_t size);
 
+// Per-load progress messages, for bring-up (-DWAMR_VERBOSE_LOAD); errors are always printed
+#ifdef WAMR_VERBOSE_LOAD
+#define LOAD_TRACE(...) printf(__VA_ARGS__)
+#else
+#define LOAD_TRACE(...) ((void)0)
+#endif
+
+// Arena receiving the calling thread's allocations while it loads a module. Loads
+// on other threads, and allocations made meanwhile by other threads, aren't affected.
+static __thread WamrArena* active_arena = NULL;
+
+// Live arenas, for ownership lookups on free/realloc from any thread. Slots are
+// claimed and released with atomics, so lookups never take a lock.
+#define WAMR_MAX_ARENAS 64
+static WamrArena* live_arenas[WAMR_MAX_ARENAS];
+
+// Arena allocations carry their size just ahead of the returned pointer
+#define ARENA_HEADER 8
+
+static bool arena_register(WamrArena* arena) {
+    for (int i = 0; i < WAMR_MAX_ARENAS; i++) {
+        WamrArena* empty = NULL;
+        if (__atomic_compare_exchange_n(&live_arenas[i], &empty, arena, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void arena_unregister(WamrArena* arena) {
+    for (int i = 0; i < WAMR_MAX_ARENAS; i++) {
+        WamrArena* expected = arena;
+        if (__atomic_compare_exchange_n(&live_arenas[i], &expected, NULL, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+static WamrArena* arena_owner(void* ptr) {
+    for (int i = 0; i < WAMR_MAX_ARENAS; i++) {
+        WamrArena* arena = __atomic_load_n(&live_arenas[i], __ATOMIC_ACQUIRE);
+        if (arena && (uint8_t*)ptr >= arena->base && (uint8_t*)ptr < arena->base + arena->size) return arena;
+    }
+    return NULL;
+}
+
+static void* arena_alloc(WamrArena* arena, unsigned size) {
+    uint32_t need = ARENA_HEADER + ((size + 7) & ~7u);
+    if (arena->size - arena->used < need) return NULL;
+    uint8_t* block = arena->base + arena->used;
+    *(uint32_t*)block = size;
+    arena->last = arena->used;
+    arena->used += need;
+    memset(block + ARENA_HEADER, 0, size);
+    return block + ARENA_HEADER;
+}
+
+// Static pool mode: WAMR gets one region sized by the WAMR_POOL_SIZE build budget,
+// reserved when the runtime starts, and allocates only from it from then on. The
+// region is managed by WAMR's own pool allocator, but allocations still go through
+// the hooks below so they come back zeroed.
+#ifdef WAMR_POOL_SIZE
+static void* runtime_pool = NULL;
+static mem_allocator_t pool_allocator = NULL;
+
+static void* backing_alloc(unsigned size) { return mem_allocator_malloc(pool_allocator, size); }
+static void* backing_realloc(void* ptr, unsigned size) { return mem_allocator_realloc(pool_allocator, ptr, size); }
+static void backing_free(void* ptr) { mem_allocator_free(pool_allocator, ptr); }
+#else
+static void* backing_alloc(unsigned size) { return sdram_alloc(size); }
+static void* backing_realloc(void* ptr, unsigned size) { return sdram_realloc(ptr, size); }
+static void backing_free(void* ptr) { sdram_dealloc(ptr); }
+#endif
+
+// Heap allocations carry their size ahead of the pointer so the runtime's
+// footprint can be tracked, and so a grown block's new tail can be zeroed
+#define HEAP_HEADER 8
+static uint32_t heap_in_use = 0;
+
+static void* heap_calloc(unsigned size) {
+    uint8_t* block = backing_alloc(size + HEAP_HEADER);
+    if (!block) return NULL;
+    memset(block, 0, size + HEAP_HEADER);
+    *(uint32_t*)block = size;
+    __atomic_fetch_add(&heap_in_use, size, __ATOMIC_RELAXED);
+    return block + HEAP_HEADER;
+}
+
+static void* heap_realloc(void* ptr, unsigned size) {
+    if (!ptr) return heap_calloc(size);
+    uint8_t* block = (uint8_t*)ptr - HEAP_HEADER;
+    uint32_t old_size = *(uint32_t*)block;
+    block = backing_realloc(block, size + HEAP_HEADER);
+    if (!block) return NULL;
+    if (size > old_size) memset(block + HEAP_HEADER + old_size, 0, size - old_size);
+    *(uint32_t*)block = size;
+    __atomic_fetch_add(&heap_in_use, size - old_size, __ATOMIC_RELAXED);
+    return block + HEAP_HEADER;
+}
+
+static void heap_free(void* ptr) {
+    if (!ptr) return;
+    uint8_t* block = (uint8_t*)ptr - HEAP_HEADER;
+    __atomic_fetch_sub(&heap_in_use, *(uint32_t*)block, __ATOMIC_RELAXED);
+    backing_free(block);
+}
+
+bool wamr_aot_runtime_pool_info(WamrPoolInfo* info) {
+#ifdef WAMR_POOL_SIZE
+    mem_alloc_info_t alloc_info;
+    if (!pool_allocator || !mem_allocator_get_alloc_info(pool_allocator, &alloc_info)) return false;
+    info->size = alloc_info.total_size;
+    info->used = alloc_info.total_size - alloc_info.total_free_size;
+    info->high_water = alloc_info.highmark_size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t wamr_aot_runtime_bytes_in_use(void) {
+    WamrPoolInfo pool;
+    if (wamr_aot_runtime_pool_info(&pool)) return pool.used;
+
+    uint32_t bytes = __atomic_load_n(&heap_in_use, __ATOMIC_RELAXED);
+    for (int i = 0; i < WAMR_MAX_ARENAS; i++) {
+        WamrArena* arena = __atomic_load_n(&live_arenas[i], __ATOMIC_ACQUIRE);
+        if (arena) bytes += arena->used;
+    }
+    return bytes;
+}
+
 // Wrapper to use calloc instead of malloc for zero-initialization
 static void* wamr_calloc_wrapper(unsigned size) {
-    // Use calloc(1, size) to get zero-initialized memory
-    return sdram_calloc(1, size);
+    if (active_arena) {
+        void* ptr = arena_alloc(active_arena, size);
+        if (ptr) return ptr;
+    }
+    return heap_calloc(size);
 }
 
+static void* wamr_realloc_wrapper(void* ptr, unsigned size) {
+    WamrArena* arena = ptr ? arena_owner(ptr) : NULL;
+    if (!arena) return heap_realloc(ptr, size);
+
+    uint8_t* block = (uint8_t*)ptr - ARENA_HEADER;
+    uint32_t old_size = *(uint32_t*)block;
+
+    // The most recent allocation of the loading arena can grow in place
+    if (arena == active_arena && block == arena->base + arena->last) {
+        uint32_t need = ARENA_HEADER + ((size + 7) & ~7u);
+        if (arena->size - arena->last >= need) {
+            if (size > old_size) memset((uint8_t*)ptr + old_size, 0, size - old_size);
+            *(uint32_t*)block = size;
+            arena->used = arena->last + need;
+            return ptr;
+        }
+    }
+
+    void* moved = wamr_calloc_wrapper(size);
+    if (moved) memcpy(moved, ptr, old_size < size ? old_size : size);
+    return moved;
+}
+
+static void wamr_free_wrapper(void* ptr) {
+    // Arena memory is released with the arena
+    if (ptr && arena_owner(ptr)) return;
+    heap_free(ptr);
+}
+
+// Default deadline hooks: no timer, overruns are only measured after the fact
+__attribute__((weak)) void wamr_deadline_arm(WamrAotEngine* engine, uint32_t budget_us) {}
+__attribute__((weak)) void wamr_deadline_disarm(void) {}
+
+// The WAMR runtime is process-wide; it is initialized by the first engine and
+// destroyed with the last so several engines can coexist
+static int runtime_refs = 0;
+
 WamrAotEngine* wamr_aot_engine_new(void) {
     WamrAotEngine* engine = sdram_calloc(1, sizeof(WamrAotEngine));
     if (!engine) return NULL;
+    engine->host_rate = WAMR_DEFAULT_SAMPLE_RATE;
+
+    if (runtime_refs == 0) {
+        RuntimeInitArgs init_args = {0};
+#ifdef WAMR_POOL_SIZE
+        runtime_pool = sdram_alloc(WAMR_POOL_SIZE);
+        if (!runtime_pool) {
+            printf("ERROR: Failed to reserve %u byte WAMR pool\n", (unsigned)WAMR_POOL_SIZE);
+            sdram_dealloc(engine);
+            return NULL;
+        }
+        pool_allocator = mem_allocator_create(runtime_pool, WAMR_POOL_SIZE);
+        if (!pool_allocator) {
+            sdram_dealloc(runtime_pool);
+            runtime_pool = NULL;
+            sdram_dealloc(engine);
+            return NULL;
+        }
+#endif
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        // Use calloc wrapper to ensure all WAMR allocations are zero-initialized
+        init_args.mem_alloc_option.allocator.malloc_func = (void*)wamr_calloc_wrapper;
+        init_args.mem_alloc_option.allocator.realloc_func = (void*)wamr_realloc_wrapper;
+        init_args.mem_alloc_option.allocator.free_func = (void*)wamr_free_wrapper;
 
-    RuntimeInitArgs init_args = {0};
-    init_args.mem_alloc_type = Alloc_With_Allocator;
-    // Use calloc wrapper to ensure all WAMR allocations are zero-initialized
-    init_args.mem_alloc_option.allocator.malloc_func = (void*)wamr_calloc_wrapper;
-    init_args.mem_alloc_option.allocator.realloc_func = (void*)sdram_realloc;
-    init_args.mem_alloc_option.allocator.free_func = (void*)sdram_dealloc;
+        if (!wasm_runtime_full_init(&init_args)) {
+#ifdef WAMR_POOL_SIZE
+            mem_allocator_destroy(pool_allocator);
+            pool_allocator = NULL;
+            sdram_dealloc(runtime_pool);
+            runtime_pool = NULL;
+#endif
+            sdram_dealloc(engine);
+            return NULL;
+        }
 
-    if (!wasm_runtime_full_init(&init_args)) {
-        sdram_dealloc(engine);
-        return NULL;
+        // Shared asset imports must be known before any module is instantiated
+        if (!wamr_assets_register_natives()) {
+            printf("ERROR: Failed to register asset natives\n");
+        }
     }
+    runtime_refs++;
 
     return engine;
 }
 
-void wamr_aot_engine_delete(WamrAotEngine* engine) {
-    if (!engine) return;
+static void destroy_instance(WamrAotEngine* engine) {
+    // Frame buffers live in the instance's linear memory
+    wamr_aot_engine_set_frames(engine, 0, false);
+    engine->frame_func = NULL;
+    engine->frame_config_offset = 0;
+
     if (engine->exec_env) wasm_runtime_destroy_exec_env(engine->exec_env);
     if (engine->instance) wasm_runtime_deinstantiate(engine->instance);
+    engine->exec_env = NULL;
+    engine->instance = NULL;
+    engine->process_func = NULL;
+    engine->control_func = NULL;
+    engine->idle_func = NULL;
+    engine->quality_func = NULL;
+    engine->rate_func = NULL;
+    engine->event_ring_offset = 0;
+}
+
+void wamr_aot_engine_unload_module(WamrAotEngine* engine) {
+    destroy_instance(engine);
     if (engine->module) wasm_runtime_unload(engine->module);
-    wasm_runtime_destroy();
+    engine->module = NULL;
+    engine->needs_recovery = false;
+
+    // Everything above freed into the arena as no-ops; drop it in one go
+    if (engine->arena.base) {
+        arena_unregister(&engine->arena);
+        sdram_dealloc(engine->arena.base);
+        memset(&engine->arena, 0, sizeof(engine->arena));
+    }
+}
+
+bool wamr_aot_engine_set_arena(WamrAotEngine* engine, uint32_t arena_size) {
+#ifdef WAMR_POOL_SIZE
+    // Every runtime allocation already comes from the pool
+    if (arena_size) {
+        printf("ERROR: Module arenas have no effect in static pool builds\n");
+        return false;
+    }
+#endif
+    engine->arena_size = arena_size;
+    return true;
+}
+
+void wamr_aot_engine_delete(WamrAotEngine* engine) {
+    if (!engine) return;
+    wamr_aot_engine_unload_module(engine);
+    wamr_aot_engine_set_stream(engine, 0, 0, 0);
+    if (engine->last_good) sdram_dealloc(engine->last_good);
+    if (--runtime_refs == 0) {
+        wasm_runtime_destroy();
+#ifdef WAMR_POOL_SIZE
+        mem_allocator_destroy(pool_allocator);
+        pool_allocator = NULL;
+        sdram_dealloc(runtime_pool);
+        runtime_pool = NULL;
+#endif
+    }
     sdram_dealloc(engine);
 }
 
+static bool load_module(WamrAotEngine* engine, uint8_t* buf, uint32_t len, WamrTier tier);
+
 bool wamr_aot_engine_load_embedded_module(WamrAotEngine* engine) {
+#ifdef WAMR_TRUSTED_MODULES
+    return wamr_aot_engine_load_module(engine, module_trusted_aot, module_trusted_aot_len, WAMR_TIER_AOT);
+#else
+    return wamr_aot_engine_load_module(engine, module_aot, module_aot_len, WAMR_TIER_AOT);
+#endif
+}
+
+bool wamr_aot_engine_load_embedded_checked_module(WamrAotEngine* engine) {
+    return wamr_aot_engine_load_module(engine, module_aot, module_aot_len, WAMR_TIER_AOT);
+}
+
+bool wamr_aot_engine_load_module(WamrAotEngine* engine, uint8_t* buf, uint32_t len, WamrTier tier) {
+    // The tier indexes the name and mode tables; negative values wrap out of range too
+    if ((unsigned)tier >= WAMR_TIER_COUNT) {
+        printf("ERROR: Unknown tier %d\n", (int)tier);
+        return false;
+    }
+
+#ifdef WAMR_POOL_SIZE
+    // Every runtime allocation already comes from the pool; set_arena() refuses arenas
+    return load_module(engine, buf, len, tier);
+#else
+    if (engine->arena_size == 0) return load_module(engine, buf, len, tier);
+
+    WamrArena* arena = &engine->arena;
+    arena->base = sdram_alloc(engine->arena_size);
+    if (!arena->base) {
+        printf("ERROR: Failed to allocate %u byte module arena\n", (unsigned)engine->arena_size);
+        return false;
+    }
+    arena->size = engine->arena_size;
+    if (!arena_register(arena)) {
+        // Too many live arenas: load from the heap like a non-arena engine
+        sdram_dealloc(arena->base);
+        memset(arena, 0, sizeof(*arena));
+        LOAD_TRACE("Arena slots exhausted, loading without an arena\n");
+        return load_module(engine, buf, len, tier);
+    }
+
+    active_arena = arena;
+    bool ok = load_module(engine, buf, len, tier);
+    active_arena = NULL;
+
+    LOAD_TRACE("Module arena: %u / %u bytes used\n", (unsigned)arena->used, (unsigned)arena->size);
+    return ok;
+#endif
+}
+
+// WAMR running mode for each bytecode tier
+static const RunningMode tier_modes[WAMR_TIER_COUNT] = {
+    [WAMR_TIER_AOT] = Mode_Default,
+    [WAMR_TIER_INTERP] = Mode_Interp,
+    [WAMR_TIER_FAST_JIT] = Mode_Fast_JIT,
+    [WAMR_TIER_LLVM_JIT] = Mode_LLVM_JIT,
+};
+
+static const char* const tier_names[WAMR_TIER_COUNT] = {"aot", "interp", "fast-jit", "llvm-jit"};
+
+const char* wamr_tier_name(WamrTier tier) {
+    return (unsigned)tier < WAMR_TIER_COUNT ? tier_names[tier] : "unknown";
+}
+
+bool wamr_tier_supported(WamrTier tier) {
+    if ((unsigned)tier >= WAMR_TIER_COUNT) return false;
+#if WASM_ENABLE_AOT == 0
+    if (tier == WAMR_TIER_AOT) return false;
+#endif
+    return tier == WAMR_TIER_AOT || wasm_runtime_is_running_mode_supported(tier_modes[tier]);
+}
+
+// Call an optional no-argument export that returns an i32; fallback if it's missing or fails
+static int32_t call_i32_export(WamrAotEngine* engine, const char* name, int32_t fallback) {
+    wasm_function_inst_t func = wasm_runtime_lookup_function(engine->instance, name);
+    uint32_t argv[1] = {0};
+    if (!func || !wasm_runtime_call_wasm(engine->exec_env, func, 0, argv)) return fallback;
+    return (int32_t)argv[0];
+}
+
+static bool instantiate_module(WamrAotEngine* engine);
+
+// Tell the module the rate it runs at: the host rate, divided when it runs in a stream
+static void apply_sample_rate(WamrAotEngine* engine) {
+    if (!engine->rate_func) return;
+    float rate = engine->host_rate / (engine->stream_rate_divisor > 1 ? engine->stream_rate_divisor : 1);
+    uint32_t argv[1];
+    memcpy(argv, &rate, sizeof(rate));
+    if (!wasm_runtime_call_wasm(engine->exec_env, engine->rate_func, 1, argv)) {
+        const char* exception = wasm_runtime_get_exception(engine->instance);
+        printf("ERROR: Module set_sample_rate() failed: %s\n", exception ? exception : "none");
+        wasm_runtime_clear_exception(engine->instance);
+    }
+}
+
+static bool load_module(WamrAotEngine* engine, uint8_t* buf, uint32_t len, WamrTier tier) {
     char error_buf[128];
 
-    printf("Loading AOT module: %p, size: %u bytes\n", module_aot, module_aot_len);
+    // AOT images start with "\0aot", bytecode with "\0asm"
+    bool is_aot = len >= 4 && memcmp(buf, "\0aot", 4) == 0;
+    if (is_aot != (tier == WAMR_TIER_AOT) || !wamr_tier_supported(tier)) {
+        printf("ERROR: Module image can't run on the %s tier in this build\n", tier_names[tier]);
+        return false;
+    }
+    engine->tier = tier;
+
+    LOAD_TRACE("Loading %s module: %p, size: %u bytes\n", tier_names[tier], buf, (unsigned)len);
 
-    engine->module = wasm_runtime_load(module_aot, module_aot_len, error_buf, sizeof(error_buf));
+    engine->module = wasm_runtime_load(buf, len, error_buf, sizeof(error_buf));
     if (!engine->module) {
-        printf("ERROR: Failed to load embedded AOT module\n");
+        printf("ERROR: Failed to load module\n");
         printf("Error buffer: '%s'\n", error_buf);
         printf("Module data starts with: %02x %02x %02x %02x\n",
-               module_aot[0], module_aot[1], module_aot[2], module_aot[3]);
+               buf[0], buf[1], buf[2], buf[3]);
+        return false;
+    }
+
+    // Unchecked code may only run where modules are trusted
+    uint32_t tag_len = 0;
+    engine->trusted = wasm_runtime_get_custom_section(engine->module, TRUSTED_SECTION, &tag_len) != NULL;
+#ifndef WAMR_TRUSTED_MODULES
+    if (engine->trusted) {
+        printf("ERROR: Refusing trusted (bounds-check-free) module in an untrusted build\n");
         return false;
     }
+#endif
+
+    // Static layout and measured profile, appended by build-wasm.sh
+    uint32_t profile_len = 0;
+    const uint8_t* profile = wasm_runtime_get_custom_section(engine->module, WAMR_PROFILE_SECTION, &profile_len);
+    memset(&engine->module_profile, 0, sizeof(engine->module_profile));
+    if (profile && profile_len >= sizeof(WamrModuleProfile)) {
+        memcpy(&engine->module_profile, profile, sizeof(WamrModuleProfile));
+    }
+    if (engine->module_profile.version != WAMR_PROFILE_VERSION) {
+        memset(&engine->module_profile, 0, sizeof(engine->module_profile));
+    }
+
+    if (!instantiate_module(engine)) return false;
+    wamr_aot_engine_set_schedule(engine, CONTROL_PERIOD_BLOCKS, IDLE_PERIOD_BLOCKS);
+    engine->sample_time = 0;
+    engine->needs_recovery = false;
+
+    LOAD_TRACE("Entry points: process%s%s%s\n",
+           engine->control_func ? ", control_tick" : "",
+           engine->idle_func ? ", idle" : "",
+           engine->quality_func ? ", set_quality" : "");
+    if (engine->module_block_size || engine->module_rate_divisor > 1) {
+        LOAD_TRACE("Module prefers %d-sample blocks at 1/%d rate\n", engine->module_block_size, engine->module_rate_divisor);
+    }
+    return true;
+}
+
+static uint32_t app_heap_size(const WamrAotEngine* engine) {
+#ifdef WAMR_PROFILE_MEMORY
+    return PROFILE_HEAP_SIZE;
+#else
+    uint32_t peak = engine->module_profile.heap_peak;
+    return peak ? WITH_MARGIN(peak) : LEGACY_HEAP_SIZE;
+#endif
+}
+
+// Native address of [begin, end) in linear memory, NULL if empty or out of bounds
+static uint8_t* app_range(WamrAotEngine* engine, uint32_t begin, uint32_t end) {
+    if (end <= begin) return NULL;
+    if (!wasm_runtime_validate_app_addr(engine->instance, begin, end - begin)) {
+        wasm_runtime_clear_exception(engine->instance);
+        return NULL;
+    }
+    return wasm_runtime_addr_app_to_native(engine->instance, begin);
+}
+
+// Create the instance and exec env of the loaded module and resolve its exports;
+// used at load and again to replace an instance abandoned by the watchdog
+static bool instantiate_module(WamrAotEngine* engine) {
+    char error_buf[128];
+    WamrTier tier = engine->tier;
 
-    engine->instance = wasm_runtime_instantiate(engine->module, STACK_SIZE, HEAP_SIZE,
+    engine->instance = wasm_runtime_instantiate(engine->module, EXEC_ENV_STACK_SIZE, app_heap_size(engine),
                                                 error_buf, sizeof(error_buf));
 
     if (!engine->instance) {
@@ -71,37 +532,479 @@ bool wamr_aot_engine_load_embedded_module(WamrAotEngine* engine) {
         return false;
     }
 
-    engine->exec_env = wasm_runtime_create_exec_env(engine->instance, STACK_SIZE);
+    if (tier != WAMR_TIER_AOT && !wasm_runtime_set_running_mode(engine->instance, tier_modes[tier])) {
+        printf("ERROR: Failed to switch instance to %s\n", tier_names[tier]);
+        return false;
+    }
+
+    engine->exec_env = wasm_runtime_create_exec_env(engine->instance, EXEC_ENV_STACK_SIZE);
     if (!engine->exec_env) {
         printf("ERROR: Failed to create execution environment\n");
         return false;
     }
 
+    // Before any module code runs: zero BSS, which function-local static guards
+    // rely on, and paint the C stack so its high-water mark can be found later
+    const WamrModuleProfile* layout = &engine->module_profile;
+    uint8_t* bss = app_range(engine, layout->bss_begin, layout->static_end);
+    if (bss) memset(bss, 0, layout->static_end - layout->bss_begin);
+    uint8_t* stack = app_range(engine, layout->stack_begin, layout->stack_end);
+    if (stack) memset(stack, STACK_PAINT, layout->stack_end - layout->stack_begin);
+
+    // Optional one-time setup, ahead of every other export
+    wasm_function_inst_t init_func = wasm_runtime_lookup_function(engine->instance, "init");
+    uint32_t init_argv[1] = {0};
+    if (init_func && !wasm_runtime_call_wasm(engine->exec_env, init_func, 0, init_argv)) {
+        const char* exception = wasm_runtime_get_exception(engine->instance);
+        printf("ERROR: Module init() failed: %s\n", exception ? exception : "none");
+        return false;
+    }
+
     engine->process_func = wasm_runtime_lookup_function(engine->instance, "process");
     if (!engine->process_func) {
         printf("ERROR: Could not find process function\n");
         return false;
     }
 
+    // Optional lower-rate entry points
+    engine->control_func = wasm_runtime_lookup_function(engine->instance, "control_tick");
+    engine->idle_func = wasm_runtime_lookup_function(engine->instance, "idle");
+    engine->quality_func = wasm_runtime_lookup_function(engine->instance, "set_quality");
+    engine->rate_func = wasm_runtime_lookup_function(engine->instance, "set_sample_rate");
+
+    // Optional event ring: the export returns the ring's address in linear memory
+    engine->event_ring_offset = 0;
+    wasm_function_inst_t ring_func = wasm_runtime_lookup_function(engine->instance, "event_ring");
+    if (ring_func) {
+        uint32_t argv[1] = {0};
+        if (wasm_runtime_call_wasm(engine->exec_env, ring_func, 0, argv) &&
+            wasm_runtime_validate_app_addr(engine->instance, argv[0], sizeof(WamrEventRing))) {
+            engine->event_ring_offset = argv[0];
+        } else {
+            printf("ERROR: event_ring export returned an invalid address\n");
+        }
+    }
+    // Optional frame mode: the config lives in linear memory like the event ring
+    engine->frame_func = wasm_runtime_lookup_function(engine->instance, "process_frame");
+    engine->frame_config_offset = 0;
+    wasm_function_inst_t frame_config_func = wasm_runtime_lookup_function(engine->instance, "frame_config");
+    if (frame_config_func) {
+        uint32_t argv[1] = {0};
+        if (wasm_runtime_call_wasm(engine->exec_env, frame_config_func, 0, argv) &&
+            wasm_runtime_validate_app_addr(engine->instance, argv[0], sizeof(WamrFrameConfig))) {
+            engine->frame_config_offset = argv[0];
+        } else {
+            printf("ERROR: frame_config export returned an invalid address\n");
+        }
+    }
+
+    // Optional block size / internal rate preferences, applied by wamr_aot_engine_set_stream()
+    engine->module_block_size = call_i32_export(engine, "preferred_block_size", 0);
+    engine->module_rate_divisor = call_i32_export(engine, "internal_rate_divisor", 1);
+    if (engine->module_block_size < 0) engine->module_block_size = 0;
+    if (engine->module_rate_divisor < 1 || engine->module_rate_divisor > WAMR_RESAMPLER_MAX_FACTOR) {
+        printf("ERROR: Unsupported internal_rate_divisor %d, running at host rate\n", (int)engine->module_rate_divisor);
+        engine->module_rate_divisor = 1;
+    }
+    apply_sample_rate(engine);
     return true;
 }
 
-void wamr_aot_engine_process(WamrAotEngine* engine, const float* input, float* output, int num_samples) {
-    if (!engine->process_func) {
-        printf("ERROR: process_func is NULL!\n");
-        return;
+void wamr_aot_engine_get_memory_profile(WamrAotEngine* engine, WamrMemoryProfile* profile) {
+    memset(profile, 0, sizeof(*profile));
+    const WamrModuleProfile* layout = &engine->module_profile;
+    profile->static_size = layout->static_end - layout->data_begin;
+    profile->stack_size = layout->stack_end - layout->stack_begin;
+    profile->heap_size = app_heap_size(engine);
+    profile->legacy_size = LEGACY_STACK_SIZE + LEGACY_HEAP_SIZE;
+    profile->profiled = layout->stack_used > 0;
+
+    // The stack grows down from stack_end; scanning up from the bottom, the first
+    // byte that lost its paint marks the high-water
+    const uint8_t* stack = app_range(engine, layout->stack_begin, layout->stack_end);
+    if (stack) {
+        uint32_t untouched = 0;
+        while (untouched < profile->stack_size && stack[untouched] == STACK_PAINT) untouched++;
+        profile->stack_used = profile->stack_size - untouched;
+    }
+
+    WASMMemoryInstance* memory = (WASMMemoryInstance*)wasm_runtime_get_default_memory(engine->instance);
+    if (memory) {
+        profile->linear_memory = (uint32_t)(memory->cur_page_count * memory->num_bytes_per_page);
+        mem_alloc_info_t info;
+        if (memory->heap_handle && mem_allocator_get_alloc_info(memory->heap_handle, &info)) {
+            profile->heap_peak = info.highmark_size;
+        }
+    }
+}
+
+#if WASM_ENABLE_PERF_PROFILING != 0
+// Resolve a function's name from the name section, falling back to exports
+static const char* func_name(AOTModule* module, uint32_t func_index) {
+#if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
+    for (uint32_t i = 0; i < module->aux_func_name_count; i++) {
+        if (module->aux_func_indexes[i] == func_index) return module->aux_func_names[i];
+    }
+#endif
+    for (uint32_t i = 0; i < module->export_count; i++) {
+        if (module->exports[i].kind == EXPORT_KIND_FUNC && module->exports[i].index == func_index) {
+            return module->exports[i].name;
+        }
+    }
+    return NULL;
+}
+
+// Fill the profile of defined function i; returns false if it was never called
+static bool func_profile(AOTModuleInstance* inst, uint32_t i, WamrFuncProfile* profile) {
+    AOTModule* module = (AOTModule*)inst->module;
+    AOTFuncPerfProfInfo* perf = &inst->func_perf_profilings[i];
+    if (perf->total_exec_cnt == 0) return false;
+
+    profile->func_index = module->import_func_count + i;
+    profile->name = func_name(module, profile->func_index);
+    profile->calls = perf->total_exec_cnt;
+    profile->total_us = perf->total_exec_time;
+    profile->self_us = perf->total_exec_time - perf->children_exec_time;
+    return true;
+}
+#endif
+
+int wamr_aot_engine_get_func_profiles(WamrAotEngine* engine, WamrFuncProfile* profiles, int max_funcs) {
+#if WASM_ENABLE_PERF_PROFILING != 0
+    // The profiling hooks are compiled into AOT code; other tiers have no such data
+    if (engine->tier != WAMR_TIER_AOT || !engine->instance) return -1;
+    AOTModuleInstance* inst = (AOTModuleInstance*)engine->instance;
+    uint32_t func_count = ((AOTModule*)inst->module)->func_count;
+    int count = 0;
+    for (uint32_t i = 0; i < func_count && count < max_funcs; i++) {
+        if (func_profile(inst, i, &profiles[count])) count++;
+    }
+    return count;
+#else
+    return -1;
+#endif
+}
+
+void wamr_aot_engine_write_func_profile_csv(WamrAotEngine* engine, WamrWriteLine write_line, void* ctx) {
+    write_line("index,name,calls,total_us,self_us", ctx);
+#if WASM_ENABLE_PERF_PROFILING != 0
+    if (engine->tier != WAMR_TIER_AOT || !engine->instance) return;
+    AOTModuleInstance* inst = (AOTModuleInstance*)engine->instance;
+    uint32_t func_count = ((AOTModule*)inst->module)->func_count;
+    WamrFuncProfile profile;
+    char line[160];
+    for (uint32_t i = 0; i < func_count; i++) {
+        if (!func_profile(inst, i, &profile)) continue;
+        snprintf(line, sizeof(line), "%u,%s,%u,%llu,%llu", (unsigned)profile.func_index,
+                 profile.name ? profile.name : "", (unsigned)profile.calls,
+                 (unsigned long long)profile.total_us, (unsigned long long)profile.self_us);
+        write_line(line, ctx);
+    }
+#endif
+}
+
+void wamr_aot_engine_write_mem_consumption_csv(WamrAotEngine* engine, WamrWriteLine write_line, void* ctx) {
+    write_line("scope,part,bytes", ctx);
+#if WASM_ENABLE_MEMORY_PROFILING != 0
+    if (!engine->module || !engine->instance) return;
+    WASMModuleMemConsumption module;
+    WASMModuleInstMemConsumption inst;
+    wasm_runtime_get_module_mem_consumption(engine->module, &module);
+    wasm_runtime_get_module_inst_mem_consumption(engine->instance, &inst);
+    const struct {
+        const char* scope;
+        const char* part;
+        uint32_t bytes;
+    } parts[] = {
+        {"module", "total", module.total_size},
+        {"module", "struct", module.module_struct_size},
+        {"module", "types", module.types_size},
+        {"module", "imports", module.imports_size},
+        {"module", "functions", module.functions_size},
+        {"module", "tables", module.tables_size},
+        {"module", "memories", module.memories_size},
+        {"module", "globals", module.globals_size},
+        {"module", "exports", module.exports_size},
+        {"module", "table_segs", module.table_segs_size},
+        {"module", "data_segs", module.data_segs_size},
+        {"module", "const_strs", module.const_strs_size},
+#if WASM_ENABLE_AOT != 0
+        {"module", "aot_code", module.aot_code_size},
+#endif
+        {"instance", "total", inst.total_size},
+        {"instance", "struct", inst.module_inst_struct_size},
+        {"instance", "memories", inst.memories_size},
+        {"instance", "app_heap", inst.app_heap_size},
+        {"instance", "tables", inst.tables_size},
+        {"instance", "globals", inst.globals_size},
+        {"instance", "functions", inst.functions_size},
+        {"instance", "exports", inst.exports_size},
+    };
+    char line[64];
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        snprintf(line, sizeof(line), "%s,%s,%u", parts[i].scope, parts[i].part, (unsigned)parts[i].bytes);
+        write_line(line, ctx);
+    }
+#endif
+}
+
+// Linear memory can move when it grows, so the ring is re-resolved on every use
+static WamrEventRing* event_ring(WamrAotEngine* engine) {
+    if (!engine->event_ring_offset) return NULL;
+    return wasm_runtime_addr_app_to_native(engine->instance, engine->event_ring_offset);
+}
+
+bool wamr_aot_engine_push_event(WamrAotEngine* engine, uint32_t time, uint32_t type, float value, uint32_t data) {
+    WamrEventRing* ring = event_ring(engine);
+    if (!ring) {
+        engine->events_dropped++;
+        return false;
+    }
+
+    uint32_t write = ring->write_index;
+    if (write - __atomic_load_n(&ring->read_index, __ATOMIC_ACQUIRE) >= WAMR_EVENT_RING_CAPACITY) {
+        engine->events_dropped++;
+        return false;
+    }
+
+    WamrEvent* event = &ring->events[write & WAMR_EVENT_RING_MASK];
+    event->time = time;
+    event->type = type;
+    event->value = value;
+    event->data = data;
+    __atomic_store_n(&ring->write_index, write + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t wamr_aot_engine_sample_time(const WamrAotEngine* engine) {
+    return engine->sample_time;
+}
+
+void wamr_aot_engine_set_schedule(WamrAotEngine* engine, int control_period, int idle_period) {
+    engine->control_period = control_period;
+    engine->idle_period = idle_period;
+    engine->block_count = 0;
+    memset(engine->entry_stats, 0, sizeof(engine->entry_stats));
+}
+
+const WamrEntryStats* wamr_aot_engine_get_entry_stats(const WamrAotEngine* engine, WamrEntryPoint entry) {
+    return &engine->entry_stats[entry];
+}
+
+static void entry_account(WamrAotEngine* engine, WamrEntryPoint entry, uint32_t elapsed_us) {
+    WamrEntryStats* stats = &engine->entry_stats[entry];
+    stats->calls++;
+    stats->last_us = elapsed_us;
+    stats->total_us += elapsed_us;
+    if (elapsed_us > stats->max_us) stats->max_us = elapsed_us;
+}
+
+// Run an entry point and record its timing
+static void call_entry(WamrAotEngine* engine, WamrEntryPoint entry, wasm_function_inst_t func,
+                       uint32_t argc, uint32_t* argv) {
+    uint64 start_us = os_time_get_boot_us();
+    if (!wasm_runtime_call_wasm(engine->exec_env, func, argc, argv)) {
+        if (engine->entry_stats[entry].errors++ == 0) {
+            const char* exception = wasm_runtime_get_exception(engine->instance);
+            wamr_log(WAMR_LOG_ENTRY_FAILED, entry, 0, exception ? exception : "none");
+        }
+        wasm_runtime_clear_exception(engine->instance);
+    }
+    entry_account(engine, entry, (uint32_t)(os_time_get_boot_us() - start_us));
+}
+
+static bool entry_due(int period, uint32_t block, uint32_t phase) {
+    return period > 0 && ((block + phase) % (uint32_t)period) == 0;
+}
+
+bool wamr_aot_engine_set_deadline(WamrAotEngine* engine, uint32_t budget_us,
+                                  WamrFallbackMode mode, int max_block_size) {
+    if (engine->last_good) {
+        sdram_dealloc(engine->last_good);
+        engine->last_good = NULL;
+    }
+    engine->last_good_capacity = 0;
+    engine->last_good_len = 0;
+
+    if (budget_us > 0 && mode == WAMR_FALLBACK_LAST_GOOD) {
+        engine->last_good = sdram_calloc(max_block_size, sizeof(float));
+        if (!engine->last_good) return false;
+        engine->last_good_capacity = max_block_size;
+    }
+
+    engine->fallback_mode = mode;
+    engine->deadline_us = budget_us;
+    wamr_aot_engine_reset_deadline(engine);
+    return true;
+}
+
+void wamr_aot_engine_reset_deadline(WamrAotEngine* engine) {
+    memset(&engine->deadline_stats, 0, sizeof(engine->deadline_stats));
+    engine->consecutive_overruns = 0;
+    engine->bypassed = false;
+}
+
+const WamrDeadlineStats* wamr_aot_engine_get_deadline_stats(const WamrAotEngine* engine) {
+    return &engine->deadline_stats;
+}
+
+void wamr_aot_engine_deadline_expired(WamrAotEngine* engine) {
+    if (!engine || !engine->deadline_armed) return;
+    engine->deadline_fired = true;
+    // AOT code compiled with suspend-flag polling checks this flag at every loop
+    // header and after every call, and the interpreter does the same with thread
+    // management enabled, so even a tight loop unwinds within a few instructions.
+    // A plain atomic OR, unlike wasm_runtime_terminate() which takes locks.
+    WASMExecEnv* env = (WASMExecEnv*)engine->exec_env;
+    __atomic_fetch_or(&env->suspend_flags.flags, WASM_SUSPEND_FLAG_TERMINATE, __ATOMIC_SEQ_CST);
+}
+
+bool wamr_aot_engine_needs_recovery(const WamrAotEngine* engine) {
+    return __atomic_load_n(&engine->needs_recovery, __ATOMIC_ACQUIRE);
+}
+
+bool wamr_aot_engine_recover(WamrAotEngine* engine) {
+    if (!wamr_aot_engine_needs_recovery(engine)) return true;
+
+    // The audio path leaves the instance alone while needs_recovery is set
+    int frame_host_block = engine->frame_size ? engine->frame_host_block : 0;
+    bool frame_spread = engine->frame_slices > 1;
+    destroy_instance(engine);
+    if (!instantiate_module(engine)) {
+        destroy_instance(engine);
+        return false;
+    }
+    if (frame_host_block && wamr_aot_engine_set_frames(engine, frame_host_block, frame_spread) < 0) {
+        return false;
     }
+    // The new instance starts at full quality; bring it to the meter's level
+    if (engine->quality_func && engine->load.quality) {
+        uint32_t argv[1] = {(uint32_t)engine->load.quality};
+        call_entry(engine, WAMR_ENTRY_QUALITY, engine->quality_func, 1, argv);
+    }
+
+    engine->deadline_stats.recoveries++;
+    __atomic_store_n(&engine->needs_recovery, false, __ATOMIC_RELEASE);
+    return true;
+}
 
-    // Initialize WAMR thread environment for the calling thread (e.g., audio thread)
-    // This is safe to call multiple times - it will return true if already initialized
+// Fill a block whose module output can't be used
+static void deadline_fallback(WamrAotEngine* engine, float* output, int num_samples) {
+    engine->deadline_stats.fallbacks++;
+    if (engine->fallback_mode == WAMR_FALLBACK_LAST_GOOD && engine->last_good_len == num_samples) {
+        memcpy(output, engine->last_good, num_samples * sizeof(float));
+    } else {
+        memset(output, 0, num_samples * sizeof(float));
+    }
+}
+
+// Record the timing of one call; returns false if the watchdog terminated it
+static bool deadline_account(WamrAotEngine* engine, uint32_t elapsed_us) {
+    WamrDeadlineStats* stats = &engine->deadline_stats;
+    stats->calls++;
+    stats->last_us = elapsed_us;
+    if (elapsed_us > stats->worst_us) stats->worst_us = elapsed_us;
+
+    if (engine->deadline_fired || elapsed_us > engine->deadline_us) {
+        stats->overruns++;
+        if (++engine->consecutive_overruns >= WAMR_DEADLINE_MAX_STRIKES) {
+            engine->bypassed = true;
+        }
+    } else {
+        engine->consecutive_overruns = 0;
+    }
+
+    if (engine->deadline_fired) {
+        stats->terminations++;
+        return false;
+    }
+    return true;
+}
+
+// Initialize WAMR thread environment for the calling thread (e.g., audio thread)
+// This is safe to call multiple times - it will return true if already initialized
+static bool ensure_thread_env(void) {
     static __thread bool thread_env_initialized = false;
     if (!thread_env_initialized) {
         if (!wasm_runtime_init_thread_env()) {
-            printf("ERROR: Failed to initialize WAMR thread environment!\n");
-            return;
+            wamr_log(WAMR_LOG_THREAD_ENV_FAILED, 0, 0, NULL);
+            return false;
         }
         thread_env_initialized = true;
-        printf("Initialized WAMR thread environment for audio processing thread\n");
+        wamr_log(WAMR_LOG_THREAD_ENV_INIT, 0, 0, NULL);
+    }
+    return true;
+}
+
+// Run an audio-path entry point under the deadline watchdog and record its timing.
+// Returns false if the call failed or was terminated; after a termination the
+// instance is marked for recovery and nothing it wrote may be used.
+static bool call_guarded(WamrAotEngine* engine, WamrEntryPoint entry, wasm_function_inst_t func,
+                         uint32_t argc, uint32_t* argv) {
+    bool deadline = engine->deadline_us > 0;
+    if (deadline) {
+        engine->deadline_fired = false;
+        engine->deadline_armed = true;
+        wamr_deadline_arm(engine, engine->deadline_us);
+    }
+
+    uint64 start_us = os_time_get_boot_us();
+    bool ok = wasm_runtime_call_wasm(engine->exec_env, func, argc, argv);
+    uint32_t elapsed_us = (uint32_t)(os_time_get_boot_us() - start_us);
+    entry_account(engine, entry, elapsed_us);
+
+    if (deadline) {
+        wamr_deadline_disarm();
+        engine->deadline_armed = false;
+        if (!deadline_account(engine, elapsed_us)) {
+            WASMExecEnv* env = (WASMExecEnv*)engine->exec_env;
+            __atomic_fetch_and(&env->suspend_flags.flags, ~WASM_SUSPEND_FLAG_TERMINATE, __ATOMIC_SEQ_CST);
+            wasm_runtime_clear_exception(engine->instance);
+            __atomic_store_n(&engine->needs_recovery, true, __ATOMIC_RELEASE);
+            wamr_log(WAMR_LOG_CALL_TERMINATED, entry, elapsed_us, NULL);
+            return false;
+        }
+    }
+
+    if (!ok) {
+        if (engine->entry_stats[entry].errors++ == 0) {
+            const char* exception = wasm_runtime_get_exception(engine->instance);
+            if (entry == WAMR_ENTRY_PROCESS) {
+                wamr_log(WAMR_LOG_CALL_FAILED, 0, 0, exception ? exception : "none");
+            } else {
+                wamr_log(WAMR_LOG_ENTRY_FAILED, entry, 0, exception ? exception : "none");
+            }
+        }
+        wasm_runtime_clear_exception(engine->instance);
+    }
+    return ok;
+}
+
+// One call of the module's process() on num_samples at its own rate
+static void process_block(WamrAotEngine* engine, const float* input, float* output, int num_samples) {
+    // Module overran too many blocks in a row, or its instance is waiting to be
+    // replaced after a terminated call: keep it out of the audio path. Checked
+    // first, because wamr_aot_engine_recover() clears the entry points while it
+    // re-instantiates.
+    if (engine->bypassed || wamr_aot_engine_needs_recovery(engine)) {
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+
+    // No instance: the output must still be written, or the codec replays a stale buffer
+    if (!engine->process_func) {
+        wamr_log(WAMR_LOG_PROCESS_NULL, 0, 0, NULL);
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+
+    if (!ensure_thread_env()) return;
+
+    uint32_t block = engine->block_count++;
+
+    // Control-rate work runs ahead of the block it affects
+    if (engine->control_func && entry_due(engine->control_period, block, 0)) {
+        call_entry(engine, WAMR_ENTRY_CONTROL, engine->control_func, 0, NULL);
     }
 
     // Get WASM module's memory instance
@@ -109,7 +1012,7 @@ void wamr_aot_engine_process(WamrAotEngine* engine, const float* input, float* o
     uint32_t output_offset = wasm_runtime_module_malloc(engine->instance, num_samples * sizeof(float), NULL);
     
     if (input_offset == 0 || output_offset == 0) {
-        printf("ERROR: Failed to allocate WASM memory\n");
+        wamr_log(WAMR_LOG_MODULE_MALLOC_FAILED, num_samples * sizeof(float), 0, NULL);
         if (input_offset) wasm_runtime_module_free(engine->instance, input_offset);
         if (output_offset) wasm_runtime_module_free(engine->instance, output_offset);
         return;
@@ -127,28 +1030,403 @@ void wamr_aot_engine_process(WamrAotEngine* engine, const float* input, float* o
     argv[1] = output_offset;
     argv[2] = num_samples;
     
-    if (wasm_runtime_call_wasm(engine->exec_env, engine->process_func, 3, argv)) {
+    // Tell the module where this block starts so it can place queued events
+    WamrEventRing* ring = event_ring(engine);
+    if (ring) ring->block_time = engine->sample_time;
+    engine->sample_time += num_samples;
+
+    bool ok = call_guarded(engine, WAMR_ENTRY_PROCESS, engine->process_func, 3, argv);
+    if (wamr_aot_engine_needs_recovery(engine)) {
+        // Terminated mid-block: the output buffer holds a partial result and the
+        // instance is discarded, so its buffers aren't worth freeing
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+
+    if (ok) {
         // Copy output buffer from WASM memory
         void* output_mem_ptr = wasm_runtime_addr_app_to_native(engine->instance, output_offset);
         if (output_mem_ptr) {
             memcpy(output, output_mem_ptr, num_samples * sizeof(float));
+            if (engine->last_good && num_samples <= engine->last_good_capacity) {
+                memcpy(engine->last_good, output, num_samples * sizeof(float));
+                engine->last_good_len = num_samples;
+            }
         }
         
-        static int debug_count = 0;
-        if (debug_count < 3) {
-            printf("WAMR process call succeeded\n");
-            debug_count++;
-        }
-    } else {
-        static int error_count = 0;
-        if (error_count < 1) {
-            const char* exception = wasm_runtime_get_exception(engine->instance);
-            printf("ERROR: WAMR call failed! Exception: %s\n", exception ? exception : "none");
-            error_count++;
+        if (engine->entry_stats[WAMR_ENTRY_PROCESS].calls <= 3) {
+            wamr_log(WAMR_LOG_PROCESS_OK, 0, 0, NULL);
         }
     }
     
     // Free WASM memory
     wasm_runtime_module_free(engine->instance, input_offset);
     wasm_runtime_module_free(engine->instance, output_offset);
+
+    // Background work fills the time left after the block is delivered
+    if (engine->idle_func && entry_due(engine->idle_period, block, engine->idle_period / 2)) {
+        call_entry(engine, WAMR_ENTRY_IDLE, engine->idle_func, 0, NULL);
+    }
+}
+
+static int gcd(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int configure_stream(WamrAotEngine* engine, int host_block, int block_size, int rate_divisor) {
+    if (engine->fifo_in) sdram_dealloc(engine->fifo_in);
+    if (engine->fifo_out) sdram_dealloc(engine->fifo_out);
+    if (engine->decimator) sdram_dealloc(engine->decimator);
+    if (engine->interpolator) sdram_dealloc(engine->interpolator);
+    engine->fifo_in = engine->fifo_out = NULL;
+    engine->decimator = engine->interpolator = NULL;
+    engine->stream_block = 0;
+    engine->stream_rate_divisor = 1;
+    engine->stream_latency = 0;
+    engine->stream_underruns = 0;
+    if (host_block <= 0) return 0;
+
+    if (rate_divisor == 0) rate_divisor = engine->module_rate_divisor ? engine->module_rate_divisor : 1;
+    if (rate_divisor < 1 || rate_divisor > WAMR_RESAMPLER_MAX_FACTOR) return -1;
+
+    // Host block at the internal rate, and the block the module will actually see
+    int internal_block = (host_block + rate_divisor - 1) / rate_divisor;
+    if (block_size == 0) block_size = engine->module_block_size ? engine->module_block_size : internal_block;
+    if (block_size == internal_block && rate_divisor == 1) return 0;
+
+    // Output primed with enough silence that a full block is always ready in time.
+    // With whole host blocks landing on the same phase the FIFOs only ever hold
+    // multiples of gcd(block, host block) samples, which trims the priming.
+    int primed = host_block % rate_divisor == 0 ? block_size - gcd(block_size, internal_block) : block_size;
+
+    engine->fifo_in = sdram_calloc(block_size + internal_block, sizeof(float));
+    engine->fifo_out = sdram_calloc(primed + 2 * block_size + internal_block, sizeof(float));
+    if (!engine->fifo_in || !engine->fifo_out) {
+        configure_stream(engine, 0, 0, 0);
+        return -1;
+    }
+
+    int latency = primed * rate_divisor;
+    if (rate_divisor > 1) {
+        engine->decimator = sdram_alloc(sizeof(WamrResampler));
+        engine->interpolator = sdram_alloc(sizeof(WamrResampler));
+        if (!engine->decimator || !engine->interpolator ||
+            !wamr_resampler_init(engine->decimator, rate_divisor, false) ||
+            !wamr_resampler_init(engine->interpolator, rate_divisor, true)) {
+            configure_stream(engine, 0, 0, 0);
+            return -1;
+        }
+        latency += wamr_resampler_round_trip_delay(rate_divisor);
+    }
+
+    engine->fifo_in_count = 0;
+    engine->fifo_out_count = primed;
+    engine->stream_host_block = host_block;
+    engine->stream_block = block_size;
+    engine->stream_rate_divisor = rate_divisor;
+    engine->stream_latency = latency;
+    return latency;
+}
+
+int wamr_aot_engine_set_stream(WamrAotEngine* engine, int host_block, int block_size, int rate_divisor) {
+    int latency = configure_stream(engine, host_block, block_size, rate_divisor);
+    // A terminated instance isn't called again; its replacement is told the rate
+    // when wamr_aot_engine_recover() instantiates it
+    if (!wamr_aot_engine_needs_recovery(engine)) apply_sample_rate(engine);
+    return latency;
+}
+
+void wamr_aot_engine_set_sample_rate(WamrAotEngine* engine, float host_rate) {
+    engine->host_rate = host_rate;
+    if (!wamr_aot_engine_needs_recovery(engine)) apply_sample_rate(engine);
+}
+
+// Re-block up to stream_host_block host samples through the module
+static void process_stream(WamrAotEngine* engine, const float* input, float* output, int num_samples) {
+    const int block = engine->stream_block;
+
+    // Queue the input at the internal rate
+    float* in_tail = engine->fifo_in + engine->fifo_in_count;
+    if (engine->decimator) {
+        engine->fifo_in_count += wamr_resampler_decimate(engine->decimator, input, num_samples, in_tail);
+    } else {
+        memcpy(in_tail, input, num_samples * sizeof(float));
+        engine->fifo_in_count += num_samples;
+    }
+
+    // Run every complete block
+    int read = 0;
+    while (engine->fifo_in_count - read >= block) {
+        process_block(engine, engine->fifo_in + read, engine->fifo_out + engine->fifo_out_count, block);
+        engine->fifo_out_count += block;
+        read += block;
+    }
+    if (read) {
+        engine->fifo_in_count -= read;
+        memmove(engine->fifo_in, engine->fifo_in + read, engine->fifo_in_count * sizeof(float));
+    }
+
+    // Play out at the host rate
+    int needed;
+    if (engine->interpolator) {
+        needed = wamr_resampler_interpolate(engine->interpolator, engine->fifo_out, engine->fifo_out_count,
+                                            output, num_samples);
+    } else {
+        needed = num_samples;
+        int available = needed < engine->fifo_out_count ? needed : engine->fifo_out_count;
+        memcpy(output, engine->fifo_out, available * sizeof(float));
+        memset(output + available, 0, (num_samples - available) * sizeof(float));
+    }
+    if (needed > engine->fifo_out_count) {
+        engine->stream_underruns++;
+        wamr_log(WAMR_LOG_STREAM_UNDERRUN, needed - engine->fifo_out_count, 0, NULL);
+        needed = engine->fifo_out_count;
+    }
+    engine->fifo_out_count -= needed;
+    memmove(engine->fifo_out, engine->fifo_out + needed, engine->fifo_out_count * sizeof(float));
+}
+
+int wamr_aot_engine_set_frames(WamrAotEngine* engine, int host_block, bool spread) {
+    if (engine->instance) {
+        if (engine->frame_in_offset) wasm_runtime_module_free(engine->instance, engine->frame_in_offset);
+        if (engine->frame_out_offset) wasm_runtime_module_free(engine->instance, engine->frame_out_offset);
+    }
+    float** buffers[] = {&engine->frame_history, &engine->frame_analysis, &engine->frame_synthesis,
+                         &engine->frame_ola, &engine->frame_out};
+    for (size_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++) {
+        if (*buffers[i]) sdram_dealloc(*buffers[i]);
+        *buffers[i] = NULL;
+    }
+    engine->frame_in_offset = engine->frame_out_offset = 0;
+    engine->frame_size = 0;
+    engine->frame_latency = 0;
+    engine->frame_underruns = 0;
+    if (host_block <= 0) return 0;
+
+    if (!engine->frame_func || !engine->frame_config_offset) {
+        printf("ERROR: Module has no frame_config/process_frame exports\n");
+        return -1;
+    }
+    const WamrFrameConfig* config = wasm_runtime_addr_app_to_native(engine->instance, engine->frame_config_offset);
+    int size = (int)config->frame_size;
+    int hop = (int)config->hop_size;
+    uint32_t window = config->window;
+    if (size <= 0 || hop <= 0 || hop > size || size % hop != 0 || window > WAMR_WINDOW_SQRT_HANN) {
+        printf("ERROR: Unsupported frame config (size %d, hop %d, window %u)\n", size, hop, (unsigned)window);
+        return -1;
+    }
+
+    // Spread each frame over the blocks until the next one is due
+    int slices = spread && hop > host_block ? hop / host_block : 1;
+
+    // Same priming as the re-blocker, with a hop as the block, plus the blocks a
+    // spread frame takes to finish
+    int primed = hop - gcd(hop, host_block) + (slices - 1) * host_block;
+
+    engine->frame_history = sdram_calloc(size, sizeof(float));
+    engine->frame_analysis = sdram_calloc(size, sizeof(float));
+    engine->frame_synthesis = sdram_calloc(size, sizeof(float));
+    engine->frame_ola = sdram_calloc(size, sizeof(float));
+    engine->frame_out = sdram_calloc(primed + 2 * hop + 2 * host_block, sizeof(float));
+    engine->frame_in_offset = wasm_runtime_module_malloc(engine->instance, size * sizeof(float), NULL);
+    engine->frame_out_offset = wasm_runtime_module_malloc(engine->instance, size * sizeof(float), NULL);
+    if (!engine->frame_history || !engine->frame_analysis || !engine->frame_synthesis ||
+        !engine->frame_ola || !engine->frame_out || !engine->frame_in_offset || !engine->frame_out_offset) {
+        printf("ERROR: Failed to allocate %d-sample frame buffers\n", size);
+        wamr_aot_engine_set_frames(engine, 0, false);
+        return -1;
+    }
+
+    // Periodic windows; the overlap-add gain makes the hops sum back to unity
+    const float pi = 3.14159265f;
+    float overlap = 0.f;
+    for (int i = 0; i < size; i++) {
+        float hann = 0.5f - 0.5f * cosf(2.f * pi * i / size);
+        float analysis = window == WAMR_WINDOW_RECT ? 1.f : window == WAMR_WINDOW_HANN ? hann : sqrtf(hann);
+        float synthesis = window == WAMR_WINDOW_SQRT_HANN ? sqrtf(hann) : 1.f;
+        engine->frame_analysis[i] = analysis;
+        engine->frame_synthesis[i] = synthesis;
+        overlap += analysis * synthesis;
+    }
+    for (int i = 0; i < size; i++) {
+        engine->frame_synthesis[i] *= hop / overlap;
+    }
+
+    engine->frame_hop = hop;
+    engine->frame_host_block = host_block;
+    engine->frame_slices = slices;
+    engine->frame_slice = slices;
+    engine->frame_history_pos = 0;
+    engine->frame_hop_count = 0;
+    engine->frame_out_count = primed;
+    engine->frame_latency = primed + size - hop;
+    engine->frame_size = size;
+    return engine->frame_latency;
+}
+
+// Run the next slice of the pending frame; after the last one, overlap-add it
+// and release one hop of finished output. Returns false if the call was terminated.
+static bool frame_run_slice(WamrAotEngine* engine) {
+    uint32_t argv[5] = {engine->frame_in_offset, engine->frame_out_offset, (uint32_t)engine->frame_size,
+                        (uint32_t)engine->frame_slice, (uint32_t)engine->frame_slices};
+    if (!call_guarded(engine, WAMR_ENTRY_FRAME, engine->frame_func, 5, argv) &&
+        wamr_aot_engine_needs_recovery(engine)) {
+        return false;
+    }
+    if (++engine->frame_slice < engine->frame_slices) return true;
+
+    const int size = engine->frame_size;
+    const int hop = engine->frame_hop;
+    const float* frame = wasm_runtime_addr_app_to_native(engine->instance, engine->frame_out_offset);
+    float* ola = engine->frame_ola;
+    for (int i = 0; i < size; i++) {
+        ola[i] += frame[i] * engine->frame_synthesis[i];
+    }
+    memcpy(engine->frame_out + engine->frame_out_count, ola, hop * sizeof(float));
+    engine->frame_out_count += hop;
+    memmove(ola, ola + hop, (size - hop) * sizeof(float));
+    memset(ola + size - hop, 0, hop * sizeof(float));
+    return true;
+}
+
+// Window the last frame_size input samples into the module and start on them.
+// Returns false if a call was terminated.
+static bool frame_capture(WamrAotEngine* engine, uint32_t frame_time) {
+    // A frame still in progress must finish before its input buffer is reused
+    while (engine->frame_slice < engine->frame_slices) {
+        if (!frame_run_slice(engine)) return false;
+    }
+
+    const int size = engine->frame_size;
+    const int oldest = engine->frame_history_pos;
+    float* frame = wasm_runtime_addr_app_to_native(engine->instance, engine->frame_in_offset);
+    for (int i = 0; i < size - oldest; i++) {
+        frame[i] = engine->frame_history[oldest + i] * engine->frame_analysis[i];
+    }
+    for (int i = size - oldest; i < size; i++) {
+        frame[i] = engine->frame_history[i - (size - oldest)] * engine->frame_analysis[i];
+    }
+
+    // The module applies the events due within the frame on its first slice
+    WamrEventRing* ring = event_ring(engine);
+    if (ring) ring->block_time = frame_time;
+    engine->frame_slice = 0;
+    return frame_run_slice(engine);
+}
+
+static void process_frames(WamrAotEngine* engine, const float* input, float* output, int num_samples) {
+    // Same guards, in the same order, as process_block()
+    if (engine->bypassed || wamr_aot_engine_needs_recovery(engine)) {
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+    if (!engine->frame_func) {
+        wamr_log(WAMR_LOG_PROCESS_NULL, 0, 0, NULL);
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+
+    if (!ensure_thread_env()) return;
+
+    uint32_t block = engine->block_count++;
+    if (engine->control_func && entry_due(engine->control_period, block, 0)) {
+        call_entry(engine, WAMR_ENTRY_CONTROL, engine->control_func, 0, NULL);
+    }
+
+    // Carry on with a frame spread over several blocks, one slice per block
+    bool ok = engine->frame_slice >= engine->frame_slices || frame_run_slice(engine);
+
+    for (int i = 0; ok && i < num_samples; i++) {
+        engine->frame_history[engine->frame_history_pos] = input[i];
+        if (++engine->frame_history_pos == engine->frame_size) engine->frame_history_pos = 0;
+        if (++engine->frame_hop_count == engine->frame_hop) {
+            engine->frame_hop_count = 0;
+            ok = frame_capture(engine, engine->sample_time + i + 1 - engine->frame_size);
+        }
+    }
+    engine->sample_time += num_samples;
+
+    if (!ok) {
+        // Terminated: the frame state goes with the instance when it is recovered
+        deadline_fallback(engine, output, num_samples);
+        return;
+    }
+
+    int available = num_samples < engine->frame_out_count ? num_samples : engine->frame_out_count;
+    memcpy(output, engine->frame_out, available * sizeof(float));
+    if (available < num_samples) {
+        memset(output + available, 0, (num_samples - available) * sizeof(float));
+        engine->frame_underruns++;
+        wamr_log(WAMR_LOG_STREAM_UNDERRUN, num_samples - available, 0, NULL);
+    }
+    engine->frame_out_count -= available;
+    memmove(engine->frame_out, engine->frame_out + available, engine->frame_out_count * sizeof(float));
+    if (engine->last_good && num_samples <= engine->last_good_capacity) {
+        memcpy(engine->last_good, output, num_samples * sizeof(float));
+        engine->last_good_len = num_samples;
+    }
+
+    if (engine->idle_func && entry_due(engine->idle_period, block, engine->idle_period / 2)) {
+        call_entry(engine, WAMR_ENTRY_IDLE, engine->idle_func, 0, NULL);
+    }
+}
+
+void wamr_aot_engine_set_load_meter(WamrAotEngine* engine, uint32_t sample_rate,
+                                    float degrade_above, float restore_below) {
+    wamr_load_meter_init(&engine->load, degrade_above, restore_below);
+    engine->sample_rate = sample_rate;
+}
+
+const WamrLoadMeter* wamr_aot_engine_get_load(const WamrAotEngine* engine) {
+    return &engine->load;
+}
+
+void wamr_aot_engine_set_synthetic_load(WamrAotEngine* engine, uint32_t extra_us) {
+    engine->synthetic_load_us = extra_us;
+}
+
+// Tell the module its new quality level; it applies from the next block
+static void signal_quality(WamrAotEngine* engine) {
+    const WamrLoadMeter* load = &engine->load;
+    wamr_log(WAMR_LOG_QUALITY_CHANGED, load->quality, (uint32_t)(load->smoothed * 100.f), NULL);
+    if (!engine->quality_func || wamr_aot_engine_needs_recovery(engine)) return;
+
+    uint32_t argv[1] = {(uint32_t)load->quality};
+    call_entry(engine, WAMR_ENTRY_QUALITY, engine->quality_func, 1, argv);
+}
+
+void wamr_aot_engine_process(WamrAotEngine* engine, const float* input, float* output, int num_samples) {
+    uint64 start_us = os_time_get_boot_us();
+    if (engine->synthetic_load_us) {
+        while (os_time_get_boot_us() - start_us < engine->synthetic_load_us) {
+        }
+    }
+
+    if (engine->frame_size) {
+        for (int done = 0; done < num_samples; done += engine->frame_host_block) {
+            int count = num_samples - done;
+            if (count > engine->frame_host_block) count = engine->frame_host_block;
+            process_frames(engine, input + done, output + done, count);
+        }
+    } else if (engine->stream_block == 0) {
+        process_block(engine, input, output, num_samples);
+    } else {
+        for (int done = 0; done < num_samples; done += engine->stream_host_block) {
+            int count = num_samples - done;
+            if (count > engine->stream_host_block) count = engine->stream_host_block;
+            process_stream(engine, input + done, output + done, count);
+        }
+    }
+
+    // Whole-call load, including any re-blocking, resampling and framing
+    if (engine->sample_rate && (engine->process_func || engine->frame_size)) {
+        uint32_t elapsed_us = (uint32_t)(os_time_get_boot_us() - start_us);
+        uint32_t period_us = (uint32_t)((uint64)num_samples * 1000000 / engine->sample_rate);
+        if (wamr_load_meter_update(&engine->load, elapsed_us, period_us)) signal_quality(engine);
+    }
 }
@@ -1,22 +1,338 @@
 #pragma once
 #include <wasm_export.h>
+#include "wamr_resampler.h"
+#include "wamr_load_meter.h"
+#include "../wasm-module/module_profile.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Host rate assumed until wamr_aot_engine_set_sample_rate() says otherwise
+#define WAMR_DEFAULT_SAMPLE_RATE 48000.f
+
+// Execution tier a module runs on. AOT needs a wamrc-compiled image, the others
+// take wasm bytecode and must be enabled in the runtime build (host only)
+typedef enum {
+    WAMR_TIER_AOT = 0,
+    WAMR_TIER_INTERP,     // fast interpreter
+    WAMR_TIER_FAST_JIT,
+    WAMR_TIER_LLVM_JIT,
+    WAMR_TIER_COUNT
+} WamrTier;
+
+// What to output for a block whose process() call was abandoned by the deadline watchdog
+typedef enum {
+    WAMR_FALLBACK_SILENCE = 0,
+    WAMR_FALLBACK_LAST_GOOD
+} WamrFallbackMode;
+
+typedef struct {
+    uint32_t calls;          // process() calls made with a deadline armed
+    uint32_t overruns;       // calls that took longer than the budget
+    uint32_t terminations;   // calls terminated by the watchdog
+    uint32_t fallbacks;      // blocks replaced by the fallback output
+    uint32_t recoveries;     // instances replaced after a terminated call
+    uint32_t last_us;        // duration of the most recent call
+    uint32_t worst_us;       // longest call seen
+} WamrDeadlineStats;
+
+// Module entry points scheduled by the engine
+typedef enum {
+    WAMR_ENTRY_PROCESS = 0,  // process(input, output, n), every block
+    WAMR_ENTRY_CONTROL,      // optional control_tick(), every control_period blocks
+    WAMR_ENTRY_IDLE,         // optional idle(), every idle_period blocks
+    WAMR_ENTRY_FRAME,        // process_frame(), in frame mode, once per frame slice
+    WAMR_ENTRY_QUALITY,      // optional set_quality(level), when the load meter changes level
+    WAMR_ENTRY_COUNT
+} WamrEntryPoint;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t errors;     // calls that trapped; only the first is logged
+} WamrEntryStats;
+
+// Measured memory use of the loaded module (see wasm-module/module_profile.h)
+typedef struct {
+    uint32_t static_size;    // initialized data + BSS
+    uint32_t stack_used;     // C stack high-water in linear memory, found by stack painting
+    uint32_t stack_size;     // C stack the module was linked with
+    uint32_t heap_peak;      // app heap high-water
+    uint32_t heap_size;      // app heap the instance was created with
+    uint32_t linear_memory;  // current linear memory size, including the app heap
+    uint32_t legacy_size;    // C stack + app heap every module got before per-module profiles
+    bool profiled;           // sizes come from the module's measured profile
+} WamrMemoryProfile;
+
+// Bump region that holds every allocation made while loading one module
+typedef struct {
+    uint8_t* base;
+    uint32_t size;
+    uint32_t used;
+    uint32_t last;           // offset of the most recent allocation, for in-place realloc
+} WamrArena;
+
+// Per-function profile, available in PERF_PROFILING builds
+typedef struct {
+    const char* name;    // from the name section or exports, NULL if unnamed
+    uint32_t func_index; // index in the module's function space
+    uint32_t calls;
+    uint64_t total_us;   // including callees
+    uint64_t self_us;    // excluding callees
+} WamrFuncProfile;
+
+typedef void (*WamrWriteLine)(const char* line, void* ctx);
+
 typedef struct {
     wasm_module_t module;
     wasm_module_inst_t instance;
     wasm_exec_env_t exec_env;
     wasm_function_inst_t process_func;
+    WamrTier tier;
+    bool trusted;  // image was compiled without bounds checks
+    WamrModuleProfile module_profile;   // from the wamr.profile section, all zero if missing
+    wasm_function_inst_t control_func;  // NULL if the module has no control_tick export
+    wasm_function_inst_t idle_func;     // NULL if the module has no idle export
+
+    // Sample-accurate event ring in linear memory (0 if the module has no event_ring export)
+    uint32_t event_ring_offset;
+    uint32_t sample_time;     // absolute time of the next block's first sample
+    uint32_t events_dropped;  // pushes rejected because the ring was full
+
+    // Arena mode (disabled when arena_size == 0)
+    uint32_t arena_size;
+    WamrArena arena;
+
+    // Multi-rate schedule, in blocks
+    int control_period;
+    int idle_period;
+    uint32_t block_count;
+    WamrEntryStats entry_stats[WAMR_ENTRY_COUNT];
+
+    // Deadline watchdog (disabled when deadline_us == 0)
+    uint32_t deadline_us;
+    WamrFallbackMode fallback_mode;
+    float* last_good;
+    int last_good_capacity;
+    int last_good_len;
+    int consecutive_overruns;
+    bool bypassed;
+    bool needs_recovery;     // a call was terminated; the instance is unusable until recovered
+    volatile bool deadline_armed;
+    volatile bool deadline_fired;
+    WamrDeadlineStats deadline_stats;
+
+    // Preferences from the optional preferred_block_size / internal_rate_divisor exports
+    int module_block_size;    // 0 = any
+    int module_rate_divisor;  // 1 = host rate
+
+    // Rate passed to the optional set_sample_rate export: the host rate divided by
+    // the divisor the stream actually runs at, which may override the module's
+    float host_rate;
+    wasm_function_inst_t rate_func;  // NULL if the module has no set_sample_rate export
+
+    // Re-blocking and internal-rate execution (disabled when stream_block == 0)
+    int stream_block;       // internal-rate samples per process() call
+    int stream_rate_divisor;  // 0 or 1 at host rate
+    int stream_host_block;  // largest host block handled in one pass
+    float* fifo_in;         // internal-rate input waiting for a full block
+    int fifo_in_count;
+    float* fifo_out;        // internal-rate output waiting to be played
+    int fifo_out_count;
+    WamrResampler* decimator;     // NULL at host rate
+    WamrResampler* interpolator;
+    int stream_latency;     // added latency in host samples
+    uint32_t stream_underruns;
+
+    // Load meter and quality signalling (disabled when sample_rate == 0)
+    uint32_t sample_rate;
+    WamrLoadMeter load;
+    wasm_function_inst_t quality_func;  // NULL if the module has no set_quality export
+    uint32_t synthetic_load_us;
+
+    // Frame mode (disabled when frame_size == 0), configured by the frame_config export
+    wasm_function_inst_t frame_func;  // NULL if the module has no process_frame export
+    uint32_t frame_config_offset;     // 0 if the module has no frame_config export
+    int frame_size;
+    int frame_hop;
+    int frame_host_block;      // largest host block handled in one pass
+    int frame_slices;          // process_frame calls per frame
+    int frame_slice;           // next slice of the pending frame; frame_slices when none is pending
+    float* frame_history;      // last frame_size input samples, circular
+    int frame_history_pos;
+    int frame_hop_count;       // input samples since the last frame
+    float* frame_analysis;     // analysis window
+    float* frame_synthesis;    // synthesis window, overlap-add gain folded in
+    float* frame_ola;          // overlap-add accumulator, frame_size samples
+    float* frame_out;          // finished samples waiting to be played
+    int frame_out_count;
+    uint32_t frame_in_offset;  // frame buffers in linear memory
+    uint32_t frame_out_offset;
+    int frame_latency;         // host samples
+    uint32_t frame_underruns;
 } WamrAotEngine;
 
 WamrAotEngine* wamr_aot_engine_new(void);
 void wamr_aot_engine_delete(WamrAotEngine* engine);
 bool wamr_aot_engine_load_embedded_module(WamrAotEngine* engine);
+
+// Load the bounds-checked embedded image even in TRUSTED_MODULES builds, for comparison
+bool wamr_aot_engine_load_embedded_checked_module(WamrAotEngine* engine);
+
+/**
+ * Load and instantiate a module image on the given tier. buf must stay valid and
+ * writable while the module is loaded (the bytecode loader may patch it in place).
+ * Images tagged as trusted (no bounds checks) are refused unless the wrapper is
+ * built with WAMR_TRUSTED_MODULES, and so are tiers outside WamrTier.
+ */
+bool wamr_aot_engine_load_module(WamrAotEngine* engine, uint8_t* buf, uint32_t len, WamrTier tier);
+// Both accept any value: out-of-range tiers are unsupported and named "unknown"
+bool wamr_tier_supported(WamrTier tier);
+const char* wamr_tier_name(WamrTier tier);
+
+// Bytes the runtime currently holds from the SDRAM heap or pool (JIT code caches excluded)
+uint32_t wamr_aot_runtime_bytes_in_use(void);
+
+typedef struct {
+    uint32_t size;
+    uint32_t used;
+    uint32_t high_water;
+} WamrPoolInfo;
+
+// Usage of the runtime's static pool; false unless built with WAMR_POOL_SIZE
+bool wamr_aot_runtime_pool_info(WamrPoolInfo* info);
+
+void wamr_aot_engine_unload_module(WamrAotEngine* engine);
+
+/**
+ * Load and instantiate subsequent modules out of a single arena_size-byte SDRAM
+ * region. Allocations are bump-allocated, frees inside the arena are no-ops and
+ * unloading releases the whole region at once. Allocations that don't fit, and
+ * reallocs after loading (e.g. memory.grow), fall back to the SDRAM heap.
+ * Pass 0 to go back to per-allocation SDRAM use. Returns false, leaving arenas
+ * off, for a non-zero size in static pool builds, where the pool already holds
+ * every runtime allocation.
+ */
+bool wamr_aot_engine_set_arena(WamrAotEngine* engine, uint32_t arena_size);
 void wamr_aot_engine_process(WamrAotEngine* engine, const float* input, float* output, int num_samples);
 
+// Fill in the module's memory profile; call after running representative blocks
+void wamr_aot_engine_get_memory_profile(WamrAotEngine* engine, WamrMemoryProfile* profile);
+
+/**
+ * Run the module at its own block size and/or 1/rate_divisor of the host rate.
+ * Host blocks of up to host_block samples are decimated into a FIFO, the module
+ * is called once per full block, and its output is interpolated back to the host
+ * rate. block_size or rate_divisor of 0 take the module's preference (host block
+ * and host rate if it has none). Returns the added latency in host samples, or
+ * -1 on failure. Event and schedule times then count internal-rate samples.
+ * Pass host_block = 0 to go back to calling the module with each host block.
+ */
+int wamr_aot_engine_set_stream(WamrAotEngine* engine, int host_block, int block_size, int rate_divisor);
+
+/**
+ * Host sample rate (WAMR_DEFAULT_SAMPLE_RATE until set). The module's optional
+ * set_sample_rate(rate) export is called with the rate it actually runs at after
+ * every instantiation and wamr_aot_engine_set_stream() call.
+ */
+void wamr_aot_engine_set_sample_rate(WamrAotEngine* engine, float host_rate);
+
+/**
+ * Switch to frame mode for a module with frame_config and process_frame exports
+ * (see wasm-module/wamr_frames.h). The host buffers input, windows each frame,
+ * overlap-adds the results and calls process() no more. With spread set, each
+ * frame is processed in hop / host_block slices over the following blocks instead
+ * of all at once, which flattens the per-block cost at the price of that many
+ * blocks of extra latency. Returns the latency in host samples, or -1 on failure.
+ * Pass host_block = 0 to leave frame mode. Replaces re-blocking while active.
+ */
+int wamr_aot_engine_set_frames(WamrAotEngine* engine, int host_block, bool spread);
+
+/**
+ * Meter every process() call against the block period at sample_rate and pass
+ * the resulting quality level (0 = full, up to WAMR_QUALITY_LEVELS - 1) to the
+ * module's optional set_quality(level) export whenever it changes. A level is
+ * shed when the smoothed load exceeds degrade_above or a block overruns, and
+ * restored below restore_below. Pass sample_rate = 0 to disable.
+ */
+void wamr_aot_engine_set_load_meter(WamrAotEngine* engine, uint32_t sample_rate,
+                                    float degrade_above, float restore_below);
+const WamrLoadMeter* wamr_aot_engine_get_load(const WamrAotEngine* engine);
+
+// Busy-wait extra_us inside every process() call to rehearse overload (0 = off)
+void wamr_aot_engine_set_synthetic_load(WamrAotEngine* engine, uint32_t extra_us);
+
+/**
+ * Queue an event for the module at absolute sample time `time` (compare with
+ * wamr_aot_engine_sample_time()). Lock-free, single producer: call from one
+ * control context only, in non-decreasing time order. Returns false and counts a
+ * drop if the ring is full or the module has no event ring.
+ */
+bool wamr_aot_engine_push_event(WamrAotEngine* engine, uint32_t time, uint32_t type, float value, uint32_t data);
+uint32_t wamr_aot_engine_sample_time(const WamrAotEngine* engine);
+
+/**
+ * Copy up to max_funcs per-function profiles of functions that have been called.
+ * Returns the number written, or -1 if the runtime was built without PERF_PROFILING
+ * or the module doesn't run on the AOT tier (the only one with profiling hooks).
+ */
+int wamr_aot_engine_get_func_profiles(WamrAotEngine* engine, WamrFuncProfile* profiles, int max_funcs);
+
+// Write the per-function profile as CSV (index,name,calls,total_us,self_us), one line per function
+void wamr_aot_engine_write_func_profile_csv(WamrAotEngine* engine, WamrWriteLine write_line, void* ctx);
+
+// Write the runtime's memory consumption breakdown of the loaded module and its
+// instance as CSV (scope,part,bytes), one line per part. Header only unless the
+// runtime was built with WASM_ENABLE_MEMORY_PROFILING (PERF_PROFILING builds).
+void wamr_aot_engine_write_mem_consumption_csv(WamrAotEngine* engine, WamrWriteLine write_line, void* ctx);
+
+/**
+ * Set how often the optional control_tick and idle exports run, in blocks.
+ * control_tick runs before the block's process() call so new parameters apply to it;
+ * idle runs after process(), offset by half its period so it never lands on the same
+ * block boundary as control_tick when the periods match. A period of 0 disables the entry point.
+ */
+void wamr_aot_engine_set_schedule(WamrAotEngine* engine, int control_period, int idle_period);
+const WamrEntryStats* wamr_aot_engine_get_entry_stats(const WamrAotEngine* engine, WamrEntryPoint entry);
+
+/**
+ * Arm a per-call execution budget for process(). If a call is still running when
+ * the budget elapses, the watchdog terminates it and the block is replaced with
+ * silence or the last good block. After WAMR_DEADLINE_MAX_STRIKES consecutive
+ * overruns the module is bypassed until wamr_aot_engine_reset_deadline() is called.
+ * Pass budget_us = 0 to disable. max_block_size sizes the last-good-block buffer.
+ *
+ * Termination needs AOT images compiled with suspend-flag polling (build-wasm.sh
+ * passes --enable-multi-thread to wamrc), or a runtime with WASM_ENABLE_THREAD_MGR
+ * for the interpreter tiers; other code is only measured after it returns.
+ */
+bool wamr_aot_engine_set_deadline(WamrAotEngine* engine, uint32_t budget_us,
+                                  WamrFallbackMode mode, int max_block_size);
+void wamr_aot_engine_reset_deadline(WamrAotEngine* engine);
+const WamrDeadlineStats* wamr_aot_engine_get_deadline_stats(const WamrAotEngine* engine);
+
+// Called by the platform timer when an armed deadline elapses (interrupt-safe)
+void wamr_aot_engine_deadline_expired(WamrAotEngine* engine);
+
+/**
+ * A terminated call leaves the instance in an undefined state (module globals
+ * half-updated, the C stack pointer in linear memory never restored), so the
+ * engine keeps outputting the fallback block until the instance is replaced.
+ * wamr_aot_engine_recover() re-instantiates the already loaded module and
+ * restores frame mode. It allocates: call it from the main loop, never from the
+ * audio callback. Returns false if the new instance couldn't be created.
+ */
+bool wamr_aot_engine_needs_recovery(const WamrAotEngine* engine);
+bool wamr_aot_engine_recover(WamrAotEngine* engine);
+
+// Platform timer hooks. The wrapper provides weak no-op versions, in which case
+// overruns are only detected after the call returns and nothing is terminated.
+void wamr_deadline_arm(WamrAotEngine* engine, uint32_t budget_us);
+void wamr_deadline_disarm(void);
+
 #ifdef __cplusplus
 }
 #endif
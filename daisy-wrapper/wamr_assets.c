@@ -0,0 +1,154 @@
+#include "wamr_assets.h"
+#include <stdio.h>
+#include <string.h>
+#include "wasm_export.h"
+
+// Forward declarations for SDRAM allocator functions
+extern void* sdram_alloc(size_t size);
+extern void sdram_dealloc(void* ptr);
+
+// File streaming chunk, small enough to keep the host's page cache warm
+#define FILE_CHUNK_SIZE (64 * 1024)
+
+static WamrAsset assets[WAMR_MAX_ASSETS];
+
+int wamr_asset_add(const char* name, const void* data, uint32_t size) {
+    if (!data || wamr_asset_find(name) >= 0) return -1;
+    for (int handle = 0; handle < WAMR_MAX_ASSETS; handle++) {
+        WamrAsset* asset = &assets[handle];
+        if (asset->data) continue;
+        strncpy(asset->name, name, WAMR_ASSET_NAME_LEN - 1);
+        asset->name[WAMR_ASSET_NAME_LEN - 1] = '\0';
+        asset->size = size;
+        asset->owned = false;
+        // Publish last so readers never see a half-filled entry
+        __atomic_store_n(&asset->data, (const uint8_t*)data, __ATOMIC_RELEASE);
+        return handle;
+    }
+    printf("ERROR: No free asset slot for %s\n", name);
+    return -1;
+}
+
+int wamr_asset_load(const char* name, const void* data, uint32_t size) {
+    uint8_t* copy = sdram_alloc(size);
+    if (!copy) {
+        printf("ERROR: Failed to allocate %u bytes for asset %s\n", (unsigned)size, name);
+        return -1;
+    }
+    memcpy(copy, data, size);
+    int handle = wamr_asset_add(name, copy, size);
+    if (handle < 0) {
+        sdram_dealloc(copy);
+        return -1;
+    }
+    assets[handle].owned = true;
+    return handle;
+}
+
+int wamr_asset_load_file(const char* name, const char* path) {
+#ifdef __arm__
+    // No filesystem behind stdio on the Daisy
+    return -1;
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("ERROR: Could not open asset file %s\n", path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = size > 0 ? sdram_alloc((size_t)size) : NULL;
+    if (!data) {
+        printf("ERROR: Failed to allocate %ld bytes for asset %s\n", size, name);
+        fclose(file);
+        return -1;
+    }
+
+    long loaded = 0;
+    while (loaded < size) {
+        long chunk = size - loaded < FILE_CHUNK_SIZE ? size - loaded : FILE_CHUNK_SIZE;
+        if (fread(data + loaded, 1, (size_t)chunk, file) != (size_t)chunk) break;
+        loaded += chunk;
+    }
+    fclose(file);
+    if (loaded != size) {
+        printf("ERROR: Short read on asset file %s\n", path);
+        sdram_dealloc(data);
+        return -1;
+    }
+
+    int handle = wamr_asset_add(name, data, (uint32_t)size);
+    if (handle < 0) {
+        sdram_dealloc(data);
+        return -1;
+    }
+    assets[handle].owned = true;
+    return handle;
+#endif
+}
+
+void wamr_asset_remove(int handle) {
+    if (handle < 0 || handle >= WAMR_MAX_ASSETS || !assets[handle].data) return;
+    if (assets[handle].owned) sdram_dealloc((void*)assets[handle].data);
+    memset(&assets[handle], 0, sizeof(assets[handle]));
+}
+
+int wamr_asset_find(const char* name) {
+    for (int handle = 0; handle < WAMR_MAX_ASSETS; handle++) {
+        if (assets[handle].data && strncmp(assets[handle].name, name, WAMR_ASSET_NAME_LEN - 1) == 0) {
+            return handle;
+        }
+    }
+    return -1;
+}
+
+const WamrAsset* wamr_asset_get(int handle) {
+    if (handle < 0 || handle >= WAMR_MAX_ASSETS || !assets[handle].data) return NULL;
+    return &assets[handle];
+}
+
+int32_t wamr_asset_read(int handle, uint32_t offset, void* dst, uint32_t len) {
+    if (handle < 0 || handle >= WAMR_MAX_ASSETS) return -1;
+    const uint8_t* data = __atomic_load_n(&assets[handle].data, __ATOMIC_ACQUIRE);
+    if (!data) return -1;
+    uint32_t size = assets[handle].size;
+    if (offset >= size) return 0;
+    if (len > size - offset) len = size - offset;
+    memcpy(dst, data + offset, len);
+    return (int32_t)len;
+}
+
+uint32_t wamr_assets_bytes(void) {
+    uint32_t bytes = 0;
+    for (int handle = 0; handle < WAMR_MAX_ASSETS; handle++) {
+        if (assets[handle].owned) bytes += assets[handle].size;
+    }
+    return bytes;
+}
+
+// Native imports; WAMR validates every pointer and length against the caller's linear memory
+static int32_t asset_find_native(wasm_exec_env_t exec_env, const char* name) {
+    return wamr_asset_find(name);
+}
+
+static int32_t asset_size_native(wasm_exec_env_t exec_env, int32_t handle) {
+    const WamrAsset* asset = wamr_asset_get(handle);
+    return asset ? (int32_t)asset->size : -1;
+}
+
+static int32_t asset_read_native(wasm_exec_env_t exec_env, int32_t handle, uint32_t offset,
+                                 void* dst, uint32_t len) {
+    return wamr_asset_read(handle, offset, dst, len);
+}
+
+static NativeSymbol asset_natives[] = {
+    {"asset_find", (void*)asset_find_native, "($)i", NULL},
+    {"asset_size", (void*)asset_size_native, "(i)i", NULL},
+    {"asset_read", (void*)asset_read_native, "(ii*~)i", NULL},
+};
+
+bool wamr_assets_register_natives(void) {
+    return wasm_runtime_register_natives("env", asset_natives, sizeof(asset_natives) / sizeof(asset_natives[0]));
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Large read-only assets (wavetables, samples, impulse responses) shared by every
+// instance. Each asset lives once in SDRAM, outside any linear memory; modules
+// copy the slices they need into their own buffers through native imports
+// (see wasm-module/wamr_asset_imports.h), so instances stay small and nothing is
+// copied per instance.
+//
+// Add and remove assets from one non-real-time context while no module is
+// reading them; reads from any number of instances are lock-free.
+
+#define WAMR_MAX_ASSETS 16
+#define WAMR_ASSET_NAME_LEN 24
+
+typedef struct {
+    char name[WAMR_ASSET_NAME_LEN];
+    const uint8_t* data;
+    uint32_t size;
+    bool owned;  // data was allocated by the registry
+} WamrAsset;
+
+// Register data that is already resident and outlives the asset (no copy). Returns the handle or -1.
+int wamr_asset_add(const char* name, const void* data, uint32_t size);
+
+// Copy data into a new SDRAM buffer once and register it. Returns the handle or -1.
+int wamr_asset_load(const char* name, const void* data, uint32_t size);
+
+// Linux host only: stream a file into SDRAM in chunks. Returns the handle or -1.
+int wamr_asset_load_file(const char* name, const char* path);
+
+void wamr_asset_remove(int handle);
+int wamr_asset_find(const char* name);
+const WamrAsset* wamr_asset_get(int handle);
+
+/**
+ * Copy up to len bytes starting at offset into dst. Returns the bytes copied,
+ * fewer at the end of the asset, or -1 for an unknown handle.
+ */
+int32_t wamr_asset_read(int handle, uint32_t offset, void* dst, uint32_t len);
+
+// Total bytes held by owned assets
+uint32_t wamr_assets_bytes(void);
+
+// Register the "env" imports with WAMR; call after runtime init, before loading modules
+bool wamr_assets_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
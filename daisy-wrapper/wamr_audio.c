@@ -0,0 +1,21 @@
+#include "wamr_audio.h"
+#include <string.h>
+
+static WamrAotEngine* audio_engine = NULL;
+
+void wamr_audio_set_engine(WamrAotEngine* engine) {
+    audio_engine = engine;
+}
+
+void wamr_audio_callback(const float* const* in, float** out, size_t size) {
+    if (!audio_engine) {
+        for (int c = 0; c < WAMR_AUDIO_CHANNELS; c++) memset(out[c], 0, size * sizeof(float));
+        return;
+    }
+
+    // Process the entire buffer at once using the WAMR wrapper
+    wamr_aot_engine_process(audio_engine, in[0], out[0], (int)size);
+
+    // Copy left channel to the others for stereo output
+    for (int c = 1; c < WAMR_AUDIO_CHANNELS; c++) memcpy(out[c], out[0], size * sizeof(float));
+}
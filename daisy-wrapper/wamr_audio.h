@@ -0,0 +1,23 @@
+#pragma once
+#include <stddef.h>
+#include "wamr_aot_wrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The audio callback, shared by the Daisy firmware (hardware.StartAudio) and the
+// Linux host's virtual audio device so both drive the engine the same way. Same
+// shape as daisy::AudioHandle::AudioCallback.
+
+#define WAMR_AUDIO_CHANNELS 2
+
+// Engine the callback runs; set before audio starts. NULL outputs silence.
+void wamr_audio_set_engine(WamrAotEngine* engine);
+
+// Process the left input through the engine and copy the result to every output channel
+void wamr_audio_callback(const float* const* in, float** out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
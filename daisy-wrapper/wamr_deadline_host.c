@@ -0,0 +1,100 @@
+#include "wamr_aot_wrapper.h"
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <time.h>
+
+// Deadline timer for the Linux host build, standing in for the Daisy's TIM5 one-shot.
+// One watchdog thread sleeps until the earliest armed deadline and expires it. Each
+// thread (audio thread, pool workers) can have one call armed at a time.
+
+#define DEADLINE_SLOTS 64
+
+typedef struct {
+    bool claimed;            // held by a thread between arm and disarm
+    WamrAotEngine* engine;   // armed engine, cleared once expired
+    struct timespec due;
+} DeadlineSlot;
+
+static pthread_mutex_t deadline_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t deadline_cond;
+static pthread_once_t deadline_once = PTHREAD_ONCE_INIT;
+static DeadlineSlot slots[DEADLINE_SLOTS];
+static __thread DeadlineSlot* thread_slot = NULL;
+
+static bool before(const struct timespec* a, const struct timespec* b) {
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static void* watchdog_main(void* arg) {
+    pthread_mutex_lock(&deadline_lock);
+    for (;;) {
+        DeadlineSlot* next = NULL;
+        for (int i = 0; i < DEADLINE_SLOTS; i++) {
+            if (slots[i].engine && (!next || before(&slots[i].due, &next->due))) next = &slots[i];
+        }
+        if (!next) {
+            pthread_cond_wait(&deadline_cond, &deadline_lock);
+            continue;
+        }
+        if (pthread_cond_timedwait(&deadline_cond, &deadline_lock, &next->due) != ETIMEDOUT) continue;
+
+        // Expire under the lock, so once wamr_deadline_disarm() returns no late
+        // expiry can reach the engine
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        for (int i = 0; i < DEADLINE_SLOTS; i++) {
+            if (slots[i].engine && !before(&now, &slots[i].due)) {
+                wamr_aot_engine_deadline_expired(slots[i].engine);
+                slots[i].engine = NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void start_watchdog(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&deadline_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, watchdog_main, NULL) != 0) return;
+    // Like TIM5 above the SAI interrupt, the watchdog must be able to preempt a
+    // SCHED_FIFO audio thread; without the privilege it runs at normal priority
+    struct sched_param param = {.sched_priority = sched_get_priority_max(SCHED_FIFO)};
+    pthread_setschedparam(thread, SCHED_FIFO, &param);
+    pthread_detach(thread);
+}
+
+void wamr_deadline_arm(WamrAotEngine* engine, uint32_t budget_us) {
+    pthread_once(&deadline_once, start_watchdog);
+    pthread_mutex_lock(&deadline_lock);
+    for (int i = 0; i < DEADLINE_SLOTS && !thread_slot; i++) {
+        if (!slots[i].claimed) {
+            slots[i].claimed = true;
+            thread_slot = &slots[i];
+        }
+    }
+    // With every slot taken the call is only measured, like with no timer at all
+    if (thread_slot) {
+        clock_gettime(CLOCK_MONOTONIC, &thread_slot->due);
+        thread_slot->due.tv_nsec += (long)(budget_us % 1000000) * 1000;
+        thread_slot->due.tv_sec += budget_us / 1000000 + thread_slot->due.tv_nsec / 1000000000;
+        thread_slot->due.tv_nsec %= 1000000000;
+        thread_slot->engine = engine;
+        pthread_cond_signal(&deadline_cond);
+    }
+    pthread_mutex_unlock(&deadline_lock);
+}
+
+void wamr_deadline_disarm(void) {
+    if (!thread_slot) return;
+    pthread_mutex_lock(&deadline_lock);
+    thread_slot->engine = NULL;
+    thread_slot->claimed = false;
+    thread_slot = NULL;
+    pthread_mutex_unlock(&deadline_lock);
+}
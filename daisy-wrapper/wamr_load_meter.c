@@ -0,0 +1,45 @@
+#include "wamr_load_meter.h"
+#include <string.h>
+
+void wamr_load_meter_init(WamrLoadMeter* meter, float degrade_above, float restore_below) {
+    memset(meter, 0, sizeof(*meter));
+    meter->degrade_above = degrade_above;
+    meter->restore_below = restore_below;
+}
+
+bool wamr_load_meter_update(WamrLoadMeter* meter, uint32_t elapsed_us, uint32_t period_us) {
+    float load = period_us ? (float)elapsed_us / (float)period_us : 0.f;
+    meter->block_load = load;
+    meter->blocks++;
+
+    // Start the average at the first reading rather than ramping up from zero
+    if (meter->blocks == 1) meter->smoothed = load;
+    meter->smoothed += (load - meter->smoothed) * WAMR_LOAD_SMOOTHING;
+
+    if (load >= meter->peak) {
+        meter->peak = load;
+        meter->peak_hold = WAMR_LOAD_PEAK_HOLD_BLOCKS;
+    } else if (meter->peak_hold > 0) {
+        meter->peak_hold--;
+    } else {
+        meter->peak *= WAMR_LOAD_PEAK_DECAY;
+    }
+
+    if (meter->dwell > 0) {
+        meter->dwell--;
+        return false;
+    }
+
+    int quality = meter->quality;
+    if ((load >= 1.f || meter->smoothed > meter->degrade_above) && quality < WAMR_QUALITY_LEVELS - 1) {
+        quality++;
+    } else if (meter->smoothed < meter->restore_below && quality > 0) {
+        quality--;
+    }
+    if (quality == meter->quality) return false;
+
+    meter->quality = quality;
+    meter->quality_changes++;
+    meter->dwell = WAMR_QUALITY_DWELL_BLOCKS;
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-block DSP load meter (processing time / block period) with smoothing, peak
+// hold, and a quality level that steps with hysteresis so modules can shed work
+// before the load turns into xruns. Pure arithmetic, no runtime dependencies.
+
+#define WAMR_QUALITY_LEVELS 4          // 0 = full quality, higher levels shed more work
+#define WAMR_LOAD_SMOOTHING 0.05f      // one-pole coefficient, ~20 blocks
+#define WAMR_LOAD_PEAK_HOLD_BLOCKS 128 // ~340 ms at 128 samples / 48 kHz
+#define WAMR_LOAD_PEAK_DECAY 0.99f     // per block once the hold has run out
+#define WAMR_QUALITY_DWELL_BLOCKS 32   // minimum blocks between quality changes
+
+typedef struct {
+    float block_load;       // most recent block
+    float smoothed;
+    float peak;
+    int quality;
+    uint32_t quality_changes;
+    uint32_t blocks;
+
+    float degrade_above;    // smoothed load that sheds one level
+    float restore_below;    // smoothed load that restores one level
+    uint32_t peak_hold;
+    uint32_t dwell;
+} WamrLoadMeter;
+
+void wamr_load_meter_init(WamrLoadMeter* meter, float degrade_above, float restore_below);
+
+/**
+ * Account one block that took elapsed_us of a period_us budget. A block that
+ * overran its period sheds a level immediately (dwell permitting); otherwise the
+ * smoothed load must cross degrade_above / restore_below. Returns true if the
+ * quality level changed.
+ */
+bool wamr_load_meter_update(WamrLoadMeter* meter, uint32_t elapsed_us, uint32_t period_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+#include "wamr_log.h"
+#include <stdio.h>
+#include <string.h>
+#include "bh_platform.h"
+
+#define LOG_CAPACITY 64  // power of two
+#define LOG_MASK (LOG_CAPACITY - 1)
+
+static WamrLogEvent ring[LOG_CAPACITY];
+static uint32_t write_index = 0;
+static uint32_t read_index = 0;
+static uint32_t dropped = 0;
+static uint32_t dropped_reported = 0;
+
+// Formats take the two integer args; text is appended when present
+static const char* const formats[WAMR_LOG_CODE_COUNT] = {
+    [WAMR_LOG_PROCESS_OK] = "WAMR process call succeeded",
+    [WAMR_LOG_PROCESS_NULL] = "ERROR: process_func is NULL!",
+    [WAMR_LOG_THREAD_ENV_INIT] = "Initialized WAMR thread environment for audio processing thread",
+    [WAMR_LOG_THREAD_ENV_FAILED] = "ERROR: Failed to initialize WAMR thread environment!",
+    [WAMR_LOG_MODULE_MALLOC_FAILED] = "ERROR: Failed to allocate WASM memory (%u bytes)",
+    [WAMR_LOG_CALL_FAILED] = "ERROR: WAMR call failed!",
+    [WAMR_LOG_ENTRY_FAILED] = "ERROR: WAMR entry point %u failed!",
+    [WAMR_LOG_STREAM_UNDERRUN] = "WARNING: Re-blocker output ran %u samples short",
+    [WAMR_LOG_QUALITY_CHANGED] = "Quality level %u (load %u%%)",
+    [WAMR_LOG_CALL_TERMINATED] = "WARNING: WAMR entry point %u terminated after %u us, instance needs recovery",
+};
+
+void wamr_log(WamrLogCode code, uint32_t arg0, uint32_t arg1, const char* text) {
+    // Reserve a slot; the CAS only retries if another producer got in first
+    uint32_t index = __atomic_load_n(&write_index, __ATOMIC_RELAXED);
+    do {
+        if (index - __atomic_load_n(&read_index, __ATOMIC_ACQUIRE) >= LOG_CAPACITY) {
+            __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&write_index, &index, index + 1, true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    WamrLogEvent* event = &ring[index & LOG_MASK];
+    event->time_us = (uint32_t)os_time_get_boot_us();
+    event->code = code;
+    event->args[0] = arg0;
+    event->args[1] = arg1;
+    event->text[0] = '\0';
+    if (text) {
+        strncpy(event->text, text, WAMR_LOG_TEXT_LEN - 1);
+        event->text[WAMR_LOG_TEXT_LEN - 1] = '\0';
+    }
+    // Publish: the consumer only reads a slot whose seq matches its position
+    __atomic_store_n(&event->seq, index + 1, __ATOMIC_RELEASE);
+}
+
+int wamr_log_drain(void (*write_line)(const char* line, void* ctx), void* ctx) {
+    char line[128];
+    int lines = 0;
+
+    uint32_t total_dropped = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+    if (total_dropped != dropped_reported) {
+        snprintf(line, sizeof(line), "WARNING: %u log events dropped (ring full)",
+                 (unsigned)(total_dropped - dropped_reported));
+        write_line(line, ctx);
+        dropped_reported = total_dropped;
+        lines++;
+    }
+
+    uint32_t index = read_index;
+    for (;;) {
+        WamrLogEvent* event = &ring[index & LOG_MASK];
+        if (__atomic_load_n(&event->seq, __ATOMIC_ACQUIRE) != index + 1) break;
+
+        int len = snprintf(line, sizeof(line), "[%10u us] ", (unsigned)event->time_us);
+        const char* format = event->code < WAMR_LOG_CODE_COUNT ? formats[event->code] : "Unknown log event %u";
+        len += snprintf(line + len, sizeof(line) - len, format,
+                        event->code < WAMR_LOG_CODE_COUNT ? event->args[0] : event->code, event->args[1]);
+        if (event->text[0] && len < (int)sizeof(line)) {
+            snprintf(line + len, sizeof(line) - len, " %s", event->text);
+        }
+        write_line(line, ctx);
+        lines++;
+
+        __atomic_store_n(&read_index, ++index, __ATOMIC_RELEASE);
+    }
+    return lines;
+}
+
+uint32_t wamr_log_dropped(void) {
+    return __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocation-free deferred logging for the audio path. wamr_log() records a
+// fixed-size binary event in constant time (no formatting, no I/O); the main
+// loop formats and prints queued events with wamr_log_drain(). Safe to call
+// from interrupts and several threads at once.
+
+typedef enum {
+    WAMR_LOG_PROCESS_OK = 0,      // first successful process() calls
+    WAMR_LOG_PROCESS_NULL,        // process() called without a resolved function
+    WAMR_LOG_THREAD_ENV_INIT,     // WAMR thread env created for a new thread
+    WAMR_LOG_THREAD_ENV_FAILED,
+    WAMR_LOG_MODULE_MALLOC_FAILED,
+    WAMR_LOG_CALL_FAILED,         // text: exception message
+    WAMR_LOG_ENTRY_FAILED,        // arg0: entry point, text: exception
+    WAMR_LOG_STREAM_UNDERRUN,     // arg0: samples short
+    WAMR_LOG_QUALITY_CHANGED,     // arg0: new level, arg1: smoothed load in percent
+    WAMR_LOG_CALL_TERMINATED,     // arg0: entry point, arg1: elapsed us; the instance awaits wamr_aot_engine_recover()
+    WAMR_LOG_CODE_COUNT
+} WamrLogCode;
+
+#define WAMR_LOG_TEXT_LEN 32
+
+typedef struct {
+    uint32_t seq;        // publication sequence, internal
+    uint32_t time_us;
+    uint32_t code;
+    uint32_t args[2];
+    char text[WAMR_LOG_TEXT_LEN];  // truncated, NUL-terminated
+} WamrLogEvent;
+
+// Record an event; text may be NULL. Drops the event if the ring is full.
+void wamr_log(WamrLogCode code, uint32_t arg0, uint32_t arg1, const char* text);
+
+/**
+ * Format queued events and pass each line to write_line, reporting any drops since
+ * the last drain first. Call from one non-real-time context. Returns lines written.
+ */
+int wamr_log_drain(void (*write_line)(const char* line, void* ctx), void* ctx);
+
+// Total events dropped because the ring was full
+uint32_t wamr_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
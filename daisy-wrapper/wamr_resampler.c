@@ -0,0 +1,88 @@
+#include "wamr_resampler.h"
+#include <math.h>
+#include <string.h>
+
+// Passband edge as a fraction of the internal-rate Nyquist frequency
+#define PASSBAND 0.9f
+
+bool wamr_resampler_init(WamrResampler* resampler, int factor, bool interpolate) {
+    if (factor < 2 || factor > WAMR_RESAMPLER_MAX_FACTOR) return false;
+    memset(resampler, 0, sizeof(*resampler));
+    resampler->factor = factor;
+    resampler->taps = factor * WAMR_RESAMPLER_TAPS_PER_PHASE;
+
+    // Blackman-windowed sinc, cutoff in cycles per host-rate sample
+    const float pi = 3.14159265f;
+    const int taps = resampler->taps;
+    const float cutoff = PASSBAND * 0.5f / factor;
+    const float center = (taps - 1) * 0.5f;
+    float sum = 0.f;
+    for (int j = 0; j < taps; j++) {
+        float t = j - center;
+        float sinc = t == 0.f ? 2.f * cutoff : sinf(2.f * pi * cutoff * t) / (pi * t);
+        float window = 0.42f - 0.5f * cosf(2.f * pi * j / (taps - 1)) + 0.08f * cosf(4.f * pi * j / (taps - 1));
+        resampler->coeffs[j] = sinc * window;
+        sum += resampler->coeffs[j];
+    }
+
+    // Unity gain at DC; zero stuffing divides the interpolator's gain by factor
+    float gain = (interpolate ? factor : 1) / sum;
+    for (int j = 0; j < taps; j++) {
+        resampler->coeffs[j] *= gain;
+    }
+    return true;
+}
+
+int wamr_resampler_round_trip_delay(int factor) {
+    return factor * WAMR_RESAMPLER_TAPS_PER_PHASE - factor;
+}
+
+int wamr_resampler_decimate(WamrResampler* resampler, const float* in, int num_in, float* out) {
+    const int taps = resampler->taps;
+    float* history = resampler->history;
+    int produced = 0;
+
+    for (int i = 0; i < num_in; i++) {
+        resampler->pos = (resampler->pos == 0 ? taps : resampler->pos) - 1;
+        history[resampler->pos] = history[resampler->pos + taps] = in[i];
+        if (++resampler->phase < resampler->factor) continue;
+        resampler->phase = 0;
+
+        // Newest sample first: history[pos + j] holds x[n - j]
+        const float* window = history + resampler->pos;
+        float acc = 0.f;
+        for (int j = 0; j < taps; j++) {
+            acc += resampler->coeffs[j] * window[j];
+        }
+        out[produced++] = acc;
+    }
+    return produced;
+}
+
+int wamr_resampler_interpolate(WamrResampler* resampler, const float* in, int num_in, float* out, int num_out) {
+    const int length = WAMR_RESAMPLER_TAPS_PER_PHASE;
+    const int factor = resampler->factor;
+    float* history = resampler->history;
+    int consumed = 0;
+
+    for (int i = 0; i < num_out; i++) {
+        if (resampler->phase == 0) {
+            float x = consumed < num_in ? in[consumed] : 0.f;
+            consumed++;
+            resampler->pos = (resampler->pos == 0 ? length : resampler->pos) - 1;
+            history[resampler->pos] = history[resampler->pos + length] = x;
+        }
+
+        // Phase p only sees the taps p, p + factor, ... of the zero-stuffed input
+        const float* window = history + resampler->pos;
+        const float* coeffs = resampler->coeffs + resampler->phase;
+        float acc = 0.f;
+        for (int k = 0; k < length; k++) {
+            acc += coeffs[k * factor] * window[k];
+        }
+        out[i] = acc;
+
+        if (++resampler->phase == factor) resampler->phase = 0;
+    }
+    return consumed;
+}
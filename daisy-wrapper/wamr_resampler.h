@@ -0,0 +1,45 @@
+#pragma once
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Polyphase FIR resamplers for running a module at 1/factor of the host rate.
+// The decimator only evaluates the outputs it keeps, and the interpolator only the
+// taps that line up with real (not zero-stuffed) input samples.
+
+#define WAMR_RESAMPLER_TAPS_PER_PHASE 8
+#define WAMR_RESAMPLER_MAX_FACTOR 4
+#define WAMR_RESAMPLER_MAX_TAPS (WAMR_RESAMPLER_TAPS_PER_PHASE * WAMR_RESAMPLER_MAX_FACTOR)
+
+typedef struct {
+    int factor;
+    int taps;     // factor * WAMR_RESAMPLER_TAPS_PER_PHASE
+    int phase;    // host-rate sample position within the current internal sample
+    int pos;      // newest entry in history
+    float coeffs[WAMR_RESAMPLER_MAX_TAPS];
+    float history[2 * WAMR_RESAMPLER_MAX_TAPS];  // mirrored so every window is contiguous
+} WamrResampler;
+
+// Design the anti-aliasing / anti-imaging lowpass for factor (2..WAMR_RESAMPLER_MAX_FACTOR)
+bool wamr_resampler_init(WamrResampler* resampler, int factor, bool interpolate);
+
+// Host-rate delay of a decimator followed by an interpolator of the same factor.
+// Each filter delays by (taps - 1) / 2; decimated samples are taken on the last
+// phase and interpolated from the first, which wins back factor - 1 samples.
+int wamr_resampler_round_trip_delay(int factor);
+
+// Consume num_in host-rate samples; returns the number of internal-rate samples written to out
+int wamr_resampler_decimate(WamrResampler* resampler, const float* in, int num_in, float* out);
+
+/**
+ * Produce num_out host-rate samples from up to num_in internal-rate samples.
+ * Returns the number of input samples the call needed; if that exceeds num_in,
+ * the missing samples were treated as silence.
+ */
+int wamr_resampler_interpolate(WamrResampler* resampler, const float* in, int num_in, float* out, int num_out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+#include "wamr_sdram_bench.h"
+#include "wamr_sdram_cache.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define MAX_THREADS 16
+#define LIVE_BLOCKS 64          // blocks each background thread keeps alive
+#define RT_PERIOD_NS 100000     // simulated audio period
+#define RT_SCRATCH_BYTES 256
+
+typedef struct {
+    bool magazines;
+    int ops;
+    unsigned seed;
+    atomic_bool* stop;
+    // real-time thread results
+    uint32_t rt_ops;
+    uint64_t rt_total_ns;
+    uint64_t rt_max_ns;
+    uint32_t rt_failures;
+} BenchThread;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void* background_main(void* arg) {
+    BenchThread* bench = arg;
+    WamrMagazine magazine;
+    if (bench->magazines) wamr_sdram_cache_attach(&magazine, false);
+
+    void* live[LIVE_BLOCKS] = {0};
+    for (int i = 0; i < bench->ops; i++) {
+        int slot = rand_r(&bench->seed) % LIVE_BLOCKS;
+        if (live[slot]) {
+            wamr_sdram_cache_free(live[slot]);
+            live[slot] = NULL;
+        } else {
+            // Mostly small blocks, the occasional large one
+            size_t size = rand_r(&bench->seed) % 16 ? 16 + rand_r(&bench->seed) % 2048 : 8192;
+            live[slot] = wamr_sdram_cache_alloc(size);
+        }
+        if ((i & 1023) == 0) wamr_sdram_cache_maintain();
+    }
+    for (int slot = 0; slot < LIVE_BLOCKS; slot++) {
+        wamr_sdram_cache_free(live[slot]);
+    }
+    if (bench->magazines) {
+        wamr_sdram_cache_flush();
+        wamr_sdram_cache_attach(NULL, false);
+    }
+    return NULL;
+}
+
+static void* realtime_main(void* arg) {
+    BenchThread* bench = arg;
+    WamrMagazine magazine;
+    if (bench->magazines) {
+        wamr_sdram_cache_attach(&magazine, true);
+        wamr_sdram_cache_reserve(RT_SCRATCH_BYTES, WAMR_MAGAZINE_BATCH);
+    }
+
+    struct timespec period = {0, RT_PERIOD_NS};
+    while (!atomic_load(bench->stop)) {
+        uint64_t start = now_ns();
+        void* scratch = wamr_sdram_cache_alloc(RT_SCRATCH_BYTES);
+        wamr_sdram_cache_free(scratch);
+        uint64_t elapsed = now_ns() - start;
+
+        bench->rt_ops++;
+        bench->rt_total_ns += elapsed;
+        if (elapsed > bench->rt_max_ns) bench->rt_max_ns = elapsed;
+        if (!scratch) bench->rt_failures++;
+        nanosleep(&period, NULL);
+    }
+
+    if (bench->magazines) {
+        wamr_sdram_cache_flush();
+        wamr_sdram_cache_attach(NULL, false);
+    }
+    return NULL;
+}
+
+static void bench_mode(bool magazines, int threads, int ops, void (*write_line)(const char* line, void* ctx),
+                       void* ctx) {
+    pthread_t background[MAX_THREADS];
+    BenchThread background_args[MAX_THREADS];
+    pthread_t realtime;
+    atomic_bool stop = false;
+    BenchThread realtime_args = {.magazines = magazines, .stop = &stop};
+
+    uint32_t contended_before = wamr_sdram_cache_core_stats()->contended;
+    pthread_create(&realtime, NULL, realtime_main, &realtime_args);
+
+    uint64_t start = now_ns();
+    for (int t = 0; t < threads; t++) {
+        background_args[t] = (BenchThread){.magazines = magazines, .ops = ops, .seed = 1234u + t, .stop = &stop};
+        pthread_create(&background[t], NULL, background_main, &background_args[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(background[t], NULL);
+    }
+    uint64_t elapsed_ns = now_ns() - start;
+
+    atomic_store(&stop, true);
+    pthread_join(realtime, NULL);
+    wamr_sdram_cache_maintain();
+
+    char line[160];
+    snprintf(line, sizeof(line), "%s,%d,%.0f,%u,%.0f,%llu,%u,%u", magazines ? "magazines" : "locked-core", threads,
+             (double)threads * ops / (elapsed_ns / 1e9), (unsigned)realtime_args.rt_ops,
+             realtime_args.rt_ops ? (double)realtime_args.rt_total_ns / realtime_args.rt_ops : 0.0,
+             (unsigned long long)realtime_args.rt_max_ns, (unsigned)realtime_args.rt_failures,
+             (unsigned)(wamr_sdram_cache_core_stats()->contended - contended_before));
+    write_line(line, ctx);
+}
+
+void wamr_sdram_bench_run(int background_threads, int ops_per_thread,
+                          void (*write_line)(const char* line, void* ctx), void* ctx) {
+    if (background_threads > MAX_THREADS) background_threads = MAX_THREADS;
+    wamr_sdram_cache_init(malloc, free);
+
+    write_line("mode,threads,bg_ops_per_sec,rt_ops,rt_avg_ns,rt_max_ns,rt_failures,core_contended", ctx);
+    bench_mode(false, background_threads, ops_per_thread, write_line, ctx);
+    bench_mode(true, background_threads, ops_per_thread, write_line, ctx);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocator contention benchmark (Linux host build only). Background threads
+// allocate and free mixed sizes while a real-time thread allocates a scratch
+// block every simulated audio period, first with every allocation going through
+// the locked core and then with per-thread magazines. Needs only the allocator
+// cache, not the runtime.
+
+/**
+ * Run both modes and write them as CSV through write_line:
+ * mode,threads,bg_ops_per_sec,rt_ops,rt_avg_ns,rt_max_ns,rt_failures,core_contended
+ */
+void wamr_sdram_bench_run(int background_threads, int ops_per_thread,
+                          void (*write_line)(const char* line, void* ctx), void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
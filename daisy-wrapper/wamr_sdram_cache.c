@@ -0,0 +1,277 @@
+#include "wamr_sdram_cache.h"
+#include <string.h>
+#ifndef __arm__
+#include <pthread.h>
+#endif
+
+#define LARGE_CLASS 0xFFFFFFFFu
+
+// Precedes every block; keeps the 8-byte alignment of the core allocator
+typedef struct {
+    uint32_t size_class;  // LARGE_CLASS for blocks that bypass the magazines
+    uint32_t capacity;    // usable bytes after the header
+} BlockHeader;
+
+static WamrCoreAlloc core_alloc = NULL;
+static WamrCoreFree core_free = NULL;
+static WamrCoreStats core_stats;
+
+// Frees deferred by real-time contexts: a lock-free stack linked through the
+// blocks themselves. Pushes only, drained with a single exchange, so no ABA.
+static void* deferred_head = NULL;
+
+#ifdef __arm__
+// Thread mode is a single context and only interrupts preempt it, so a held
+// lock is never observed by thread mode; interrupts only ever try-lock
+static uint8_t core_flag = 0;
+
+static bool core_trylock(void) {
+    return !__atomic_test_and_set(&core_flag, __ATOMIC_ACQUIRE);
+}
+
+static void core_wait_lock(void) {
+    while (!core_trylock()) {
+    }
+}
+
+static void core_unlock(void) {
+    __atomic_clear(&core_flag, __ATOMIC_RELEASE);
+}
+
+// One interrupt magazine per priority level, since only a handler of a higher
+// priority can preempt another. NMI and HardFault, whose priorities are fixed
+// above every configurable one, get the first two.
+#define INTERRUPT_MAGAZINES (2 + (1 << WAMR_MAGAZINE_PRIORITY_BITS))
+#define NVIC_IPR ((volatile const uint8_t*)0xE000E400)  // external interrupt priorities
+#define SCB_SHPR ((volatile const uint8_t*)0xE000ED18)  // system handler priorities, from MemManage
+
+static WamrMagazine interrupt_magazines[INTERRUPT_MAGAZINES] = {[0 ... INTERRUPT_MAGAZINES - 1] = {.realtime = true}};
+static WamrMagazine thread_magazine = {.realtime = false};
+
+static WamrMagazine* current_magazine(void) {
+    uint32_t ipsr;
+    __asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+    if (ipsr == 0) return &thread_magazine;
+    if (ipsr < 4) return &interrupt_magazines[ipsr - 2];
+    uint8_t priority = ipsr < 16 ? SCB_SHPR[ipsr - 4] : NVIC_IPR[ipsr - 16];
+    return &interrupt_magazines[2 + (priority >> (8 - WAMR_MAGAZINE_PRIORITY_BITS))];
+}
+
+void wamr_sdram_cache_attach(WamrMagazine* magazine, bool realtime) {
+    // Contexts are fixed by execution priority on the Daisy
+}
+#else
+static pthread_mutex_t core_mutex = PTHREAD_MUTEX_INITIALIZER;
+static __thread WamrMagazine* thread_magazine = NULL;
+
+static bool core_trylock(void) {
+    return pthread_mutex_trylock(&core_mutex) == 0;
+}
+
+static void core_wait_lock(void) {
+    pthread_mutex_lock(&core_mutex);
+}
+
+static void core_unlock(void) {
+    pthread_mutex_unlock(&core_mutex);
+}
+
+static WamrMagazine* current_magazine(void) {
+    return thread_magazine;
+}
+
+void wamr_sdram_cache_attach(WamrMagazine* magazine, bool realtime) {
+    if (magazine) {
+        memset(magazine, 0, sizeof(*magazine));
+        magazine->realtime = realtime;
+    }
+    thread_magazine = magazine;
+}
+#endif
+
+// Take the core lock; real-time contexts give up instead of waiting
+static bool core_lock(bool realtime) {
+    if (!core_trylock()) {
+        __atomic_fetch_add(&core_stats.contended, 1, __ATOMIC_RELAXED);
+        if (realtime) return false;
+        core_wait_lock();
+    }
+    core_stats.acquisitions++;
+    return true;
+}
+
+void wamr_sdram_cache_init(WamrCoreAlloc alloc, WamrCoreFree free) {
+    core_alloc = alloc;
+    core_free = free;
+}
+
+static uint32_t size_class(size_t size) {
+    uint32_t cls = 0;
+    while (cls < WAMR_MAGAZINE_CLASSES && ((size_t)WAMR_MAGAZINE_MIN_SIZE << cls) < size) cls++;
+    return cls < WAMR_MAGAZINE_CLASSES ? cls : LARGE_CLASS;
+}
+
+// New block from the core; caller holds the lock
+static void* core_block(uint32_t cls, uint32_t capacity) {
+    BlockHeader* header = core_alloc(sizeof(BlockHeader) + capacity);
+    if (!header) return NULL;
+    header->size_class = cls;
+    header->capacity = capacity;
+    return header + 1;
+}
+
+static BlockHeader* header_of(void* ptr) {
+    return (BlockHeader*)ptr - 1;
+}
+
+static void defer_free(void* ptr) {
+    void* head = __atomic_load_n(&deferred_head, __ATOMIC_RELAXED);
+    do {
+        *(void**)ptr = head;
+    } while (!__atomic_compare_exchange_n(&deferred_head, &head, ptr, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Top up one size class with up to `blocks` blocks in a single core visit
+static bool refill(WamrMagazine* magazine, uint32_t cls, int blocks) {
+    int room = WAMR_MAGAZINE_ROUNDS - magazine->count[cls];
+    if (blocks > room) blocks = room;
+    if (!core_lock(magazine->realtime)) return false;
+    int added = 0;
+    while (added < blocks) {
+        void* ptr = core_block(cls, (uint32_t)WAMR_MAGAZINE_MIN_SIZE << cls);
+        if (!ptr) break;
+        magazine->rounds[cls][magazine->count[cls]++] = ptr;
+        added++;
+    }
+    core_unlock();
+    magazine->stats.refills++;
+    return added > 0;
+}
+
+void* wamr_sdram_cache_alloc(size_t size) {
+    if (size == 0 || size > UINT32_MAX - sizeof(BlockHeader) || !core_alloc) return NULL;
+    uint32_t cls = size_class(size);
+    WamrMagazine* magazine = current_magazine();
+
+    if (cls == LARGE_CLASS || !magazine) {
+        bool realtime = magazine && magazine->realtime;
+        if (!core_lock(realtime)) {
+            magazine->stats.failures++;
+            return NULL;
+        }
+        void* ptr = core_block(cls, cls == LARGE_CLASS ? (uint32_t)size : (uint32_t)WAMR_MAGAZINE_MIN_SIZE << cls);
+        core_unlock();
+        return ptr;
+    }
+
+    magazine->stats.allocs++;
+    if (magazine->count[cls] > 0) {
+        magazine->stats.hits++;
+    } else if (!refill(magazine, cls, WAMR_MAGAZINE_BATCH)) {
+        magazine->stats.failures++;
+        return NULL;
+    }
+    return magazine->rounds[cls][--magazine->count[cls]];
+}
+
+void wamr_sdram_cache_free(void* ptr) {
+    if (!ptr) return;
+    BlockHeader* header = header_of(ptr);
+    uint32_t cls = header->size_class;
+    WamrMagazine* magazine = current_magazine();
+    bool realtime = magazine && magazine->realtime;
+
+    if (cls == LARGE_CLASS || !magazine) {
+        if (!core_lock(realtime)) {
+            magazine->stats.deferred++;
+            defer_free(ptr);
+            return;
+        }
+        core_free(header);
+        core_unlock();
+        return;
+    }
+
+    // Full: hand the oldest batch back to the core in one visit
+    if (magazine->count[cls] == WAMR_MAGAZINE_ROUNDS) {
+        if (!core_lock(realtime)) {
+            magazine->stats.deferred++;
+            defer_free(ptr);
+            return;
+        }
+        void** rounds = magazine->rounds[cls];
+        for (int i = 0; i < WAMR_MAGAZINE_BATCH; i++) {
+            core_free(header_of(rounds[i]));
+        }
+        core_unlock();
+        memmove(rounds, rounds + WAMR_MAGAZINE_BATCH, (WAMR_MAGAZINE_ROUNDS - WAMR_MAGAZINE_BATCH) * sizeof(void*));
+        magazine->count[cls] -= WAMR_MAGAZINE_BATCH;
+        magazine->stats.returns++;
+    }
+    magazine->rounds[cls][magazine->count[cls]++] = ptr;
+}
+
+void* wamr_sdram_cache_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* ptr = wamr_sdram_cache_alloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* wamr_sdram_cache_realloc(void* ptr, size_t size) {
+    if (!ptr) return wamr_sdram_cache_alloc(size);
+    if (size == 0) {
+        wamr_sdram_cache_free(ptr);
+        return NULL;
+    }
+    uint32_t capacity = header_of(ptr)->capacity;
+    if (size <= capacity) return ptr;
+    void* grown = wamr_sdram_cache_alloc(size);
+    if (!grown) return NULL;
+    memcpy(grown, ptr, capacity);
+    wamr_sdram_cache_free(ptr);
+    return grown;
+}
+
+void wamr_sdram_cache_reserve(size_t size, int blocks) {
+    uint32_t cls = size_class(size);
+    WamrMagazine* magazine = current_magazine();
+    if (cls == LARGE_CLASS || !magazine) return;
+    while (magazine->count[cls] < blocks && magazine->count[cls] < WAMR_MAGAZINE_ROUNDS) {
+        if (!refill(magazine, cls, blocks - magazine->count[cls])) break;
+    }
+}
+
+void wamr_sdram_cache_maintain(void) {
+    if (!__atomic_load_n(&deferred_head, __ATOMIC_RELAXED)) return;
+    void* ptr = __atomic_exchange_n(&deferred_head, NULL, __ATOMIC_ACQUIRE);
+    core_lock(false);
+    while (ptr) {
+        void* next = *(void**)ptr;
+        core_free(header_of(ptr));
+        ptr = next;
+    }
+    core_unlock();
+}
+
+void wamr_sdram_cache_flush(void) {
+    WamrMagazine* magazine = current_magazine();
+    if (!magazine || !core_lock(magazine->realtime)) return;
+    for (int cls = 0; cls < WAMR_MAGAZINE_CLASSES; cls++) {
+        for (int i = 0; i < magazine->count[cls]; i++) {
+            core_free(header_of(magazine->rounds[cls][i]));
+        }
+        magazine->count[cls] = 0;
+    }
+    core_unlock();
+}
+
+const WamrMagazineStats* wamr_sdram_cache_stats(void) {
+    static const WamrMagazineStats none = {0};
+    WamrMagazine* magazine = current_magazine();
+    return magazine ? &magazine->stats : &none;
+}
+
+const WamrCoreStats* wamr_sdram_cache_core_stats(void) {
+    return &core_stats;
+}
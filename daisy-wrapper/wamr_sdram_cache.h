@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Concurrency-safe front end for the SDRAM allocator. Small blocks come from
+// per-context magazines (a few cached blocks per size class) that need no lock;
+// only refills, returns and large blocks go to the shared, lock-protected core.
+// A real-time context never waits for the core lock: it only try-locks, frees
+// it can't hand back are queued lock-free for wamr_sdram_cache_maintain(), and
+// an allocation it can't satisfy from its magazine returns NULL instead of waiting.
+//
+// On the Daisy the contexts are built in and chosen by execution priority: thread
+// mode, and one real-time context per interrupt priority level (e.g. the audio
+// callback), so a handler preempting another never touches the magazine it was
+// using. On the Linux host, each thread attaches its own magazine; threads
+// without one go straight to the locked core.
+
+#define WAMR_MAGAZINE_CLASSES 9     // 16, 32, ... 4096 bytes
+#define WAMR_MAGAZINE_MIN_SIZE 16
+#define WAMR_MAGAZINE_ROUNDS 16     // cached blocks per size class
+#define WAMR_MAGAZINE_BATCH 8       // blocks moved per core refill / return
+
+// Implemented NVIC priority bits (4 on the STM32H7): one interrupt magazine per level
+#ifndef WAMR_MAGAZINE_PRIORITY_BITS
+#define WAMR_MAGAZINE_PRIORITY_BITS 4
+#endif
+
+typedef void* (*WamrCoreAlloc)(size_t size);
+typedef void (*WamrCoreFree)(void* ptr);
+
+typedef struct {
+    uint32_t allocs;
+    uint32_t hits;          // served from the magazine
+    uint32_t refills;       // batches taken from the core
+    uint32_t returns;       // batches given back to the core
+    uint32_t deferred;      // frees queued because the core was busy
+    uint32_t failures;      // real-time allocations that would have had to wait
+} WamrMagazineStats;
+
+typedef struct {
+    void* rounds[WAMR_MAGAZINE_CLASSES][WAMR_MAGAZINE_ROUNDS];
+    int count[WAMR_MAGAZINE_CLASSES];
+    bool realtime;
+    WamrMagazineStats stats;
+} WamrMagazine;
+
+typedef struct {
+    uint32_t acquisitions;
+    uint32_t contended;     // lock was held by another context
+} WamrCoreStats;
+
+// Route all allocations through the cache to core_alloc / core_free (not thread-safe themselves)
+void wamr_sdram_cache_init(WamrCoreAlloc core_alloc, WamrCoreFree core_free);
+
+// Linux host: give the calling thread its own magazine (NULL detaches and uses the core directly)
+void wamr_sdram_cache_attach(WamrMagazine* magazine, bool realtime);
+
+void* wamr_sdram_cache_alloc(size_t size);
+void* wamr_sdram_cache_calloc(size_t count, size_t size);
+void* wamr_sdram_cache_realloc(void* ptr, size_t size);
+void wamr_sdram_cache_free(void* ptr);
+
+// Fill the calling context's magazine for size ahead of real-time use
+void wamr_sdram_cache_reserve(size_t size, int blocks);
+
+// Background work: hand frees deferred by real-time contexts back to the core
+void wamr_sdram_cache_maintain(void);
+
+// Return every block cached by the calling context to the core
+void wamr_sdram_cache_flush(void);
+
+const WamrMagazineStats* wamr_sdram_cache_stats(void);
+const WamrCoreStats* wamr_sdram_cache_core_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+#include "wamr_tier_bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "bh_platform.h"
+
+static void bench_one(const WamrBenchModule* module, WamrTier tier, int blocks, int block_size,
+                      WamrWriteLine write_line, void* ctx) {
+    const uint8_t* image = tier == WAMR_TIER_AOT ? module->aot : module->wasm;
+    uint32_t image_len = tier == WAMR_TIER_AOT ? module->aot_len : module->wasm_len;
+    char line[160];
+
+    // The loader may patch the image, so every run gets a fresh copy
+    uint8_t* buf = malloc(image_len);
+    float* input = calloc(block_size, sizeof(float));
+    float* output = calloc(block_size, sizeof(float));
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!buf || !input || !output || !engine) goto done;
+    memcpy(buf, image, image_len);
+
+    uint32_t bytes_before = wamr_aot_runtime_bytes_in_use();
+    uint64 start_us = os_time_get_boot_us();
+    if (!wamr_aot_engine_load_module(engine, buf, image_len, tier)) {
+        snprintf(line, sizeof(line), "%s,%s,,,,", module->name, wamr_tier_name(tier));
+        write_line(line, ctx);
+        goto done;
+    }
+    uint64 load_us = os_time_get_boot_us() - start_us;
+    uint32_t footprint = wamr_aot_runtime_bytes_in_use() - bytes_before;
+
+    uint64 total_us = 0;
+    uint64 max_us = 0;
+    for (int b = 0; b < blocks; b++) {
+        for (int i = 0; i < block_size; i++) {
+            input[i] = (float)rand() / (float)RAND_MAX * 2.f - 1.f;
+        }
+        start_us = os_time_get_boot_us();
+        wamr_aot_engine_process(engine, input, output, block_size);
+        uint64 elapsed_us = os_time_get_boot_us() - start_us;
+        total_us += elapsed_us;
+        if (elapsed_us > max_us) max_us = elapsed_us;
+    }
+
+    snprintf(line, sizeof(line), "%s,%s,%llu,%u,%.2f,%llu", module->name, wamr_tier_name(tier),
+             (unsigned long long)load_us, (unsigned)footprint, (double)total_us / blocks,
+             (unsigned long long)max_us);
+    write_line(line, ctx);
+
+done:
+    if (engine) wamr_aot_engine_delete(engine);
+    free(output);
+    free(input);
+    free(buf);
+}
+
+void wamr_tier_bench_run(const WamrBenchModule* modules, int num_modules, int blocks, int block_size,
+                         WamrWriteLine write_line, void* ctx) {
+    write_line("module,tier,load_us,footprint_bytes,block_avg_us,block_max_us", ctx);
+
+    for (int m = 0; m < num_modules; m++) {
+        for (int t = 0; t < WAMR_TIER_COUNT; t++) {
+            WamrTier tier = (WamrTier)t;
+            const uint8_t* image = tier == WAMR_TIER_AOT ? modules[m].aot : modules[m].wasm;
+            if (!image || !wamr_tier_supported(tier)) continue;
+            bench_one(&modules[m], tier, blocks, block_size, write_line, ctx);
+        }
+    }
+}
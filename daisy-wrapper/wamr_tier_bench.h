@@ -0,0 +1,30 @@
+#pragma once
+#include "wamr_aot_wrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Execution-tier benchmark matrix (Linux host build only). Every module is run on
+// every tier the runtime was built with, reporting load/compile time, runtime
+// memory footprint and per-block process() time.
+
+typedef struct {
+    const char* name;
+    const uint8_t* wasm;  // bytecode for the interpreter and JIT tiers
+    uint32_t wasm_len;
+    const uint8_t* aot;   // wamrc image for the host target, NULL to skip AOT
+    uint32_t aot_len;
+} WamrBenchModule;
+
+/**
+ * Run the matrix and write it as CSV through write_line:
+ * module,tier,load_us,footprint_bytes,block_avg_us,block_max_us
+ * Unsupported tiers are skipped; failed loads are reported with empty fields.
+ */
+void wamr_tier_bench_run(const WamrBenchModule* modules, int num_modules, int blocks, int block_size,
+                         WamrWriteLine write_line, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,217 @@
+#include "wamr_worker_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "bh_platform.h"
+
+#define MAX_WORKERS 64
+
+typedef struct {
+    WamrWorkerPool* pool;
+    int index;
+    pthread_t thread;
+
+    // This worker's share of the current batch, claimed front to back by
+    // the owner and by thieves alike
+    atomic_int next;
+    int end;
+
+    WamrWorkerStats stats;
+} Worker;
+
+struct WamrWorkerPool {
+    int num_workers;
+    Worker workers[MAX_WORKERS];
+
+    pthread_mutex_t lock;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    uint32_t generation;  // bumped for each batch
+    bool shutdown;
+
+    const WamrPoolJob* jobs;
+    atomic_int remaining;
+    int active;  // workers inside work(), guarded by lock
+    uint64_t stats_start_us;
+};
+
+static void run_job(Worker* worker, const WamrPoolJob* job, bool stolen) {
+    uint64 start_us = os_time_get_boot_us();
+    wamr_aot_engine_process(job->engine, job->input, job->output, job->num_samples);
+    worker->stats.busy_us += os_time_get_boot_us() - start_us;
+    worker->stats.jobs++;
+    if (stolen) worker->stats.stolen++;
+}
+
+// Claim one job from victim's share; returns -1 when it is exhausted
+static int claim(Worker* victim) {
+    int index = atomic_fetch_add(&victim->next, 1);
+    return index < victim->end ? index : -1;
+}
+
+// Drain this worker's share, then steal from the others
+static void work(Worker* worker) {
+    WamrWorkerPool* pool = worker->pool;
+    int done = 0;
+    int index;
+
+    while ((index = claim(worker)) >= 0) {
+        run_job(worker, &pool->jobs[index], false);
+        done++;
+    }
+    for (int i = 1; i < pool->num_workers; i++) {
+        Worker* victim = &pool->workers[(worker->index + i) % pool->num_workers];
+        while ((index = claim(victim)) >= 0) {
+            run_job(worker, &pool->jobs[index], true);
+            done++;
+        }
+    }
+
+    if (done && atomic_fetch_sub(&pool->remaining, done) == done) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->done_cond);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void* worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+    WamrWorkerPool* pool = worker->pool;
+
+    if (!wasm_runtime_init_thread_env()) {
+        printf("ERROR: Failed to initialize WAMR thread environment for worker %d\n", worker->index);
+        return NULL;
+    }
+
+    uint32_t seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start_cond, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pool->active++;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) pthread_cond_signal(&pool->done_cond);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+WamrWorkerPool* wamr_worker_pool_new(int num_workers) {
+    if (num_workers < 1 || num_workers > MAX_WORKERS) return NULL;
+
+    WamrWorkerPool* pool = calloc(1, sizeof(WamrWorkerPool));
+    if (!pool) return NULL;
+
+    pool->num_workers = num_workers;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->stats_start_us = os_time_get_boot_us();
+
+    for (int i = 0; i < num_workers; i++) {
+        Worker* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        atomic_init(&worker->next, 0);
+    }
+
+    // Worker 0 is the thread calling wamr_worker_pool_run()
+    for (int i = 1; i < num_workers; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            printf("ERROR: Failed to start worker %d\n", i);
+            pool->num_workers = i;
+            wamr_worker_pool_delete(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+void wamr_worker_pool_delete(WamrWorkerPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+void wamr_worker_pool_run(WamrWorkerPool* pool, const WamrPoolJob* jobs, int num_jobs) {
+    if (num_jobs <= 0) return;
+
+    // A worker that woke late for the previous batch may still be scanning for
+    // work; shares can only be rewritten once it has left
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+
+    // Split the batch into contiguous, near-equal shares
+    int base = num_jobs / pool->num_workers;
+    int extra = num_jobs % pool->num_workers;
+    int start = 0;
+    for (int i = 0; i < pool->num_workers; i++) {
+        Worker* worker = &pool->workers[i];
+        int count = base + (i < extra ? 1 : 0);
+        atomic_store(&worker->next, start);
+        worker->end = start + count;
+        start += count;
+    }
+
+    pool->jobs = jobs;
+    atomic_store(&pool->remaining, num_jobs);
+
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(&pool->workers[0]);
+
+    // Barrier: every job must be finished before outputs are mixed
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->remaining) > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int wamr_worker_pool_get_stats(WamrWorkerPool* pool, WamrWorkerStats* stats, int max_workers) {
+    uint64_t wall_us = os_time_get_boot_us() - pool->stats_start_us;
+    int count = pool->num_workers < max_workers ? pool->num_workers : max_workers;
+    for (int i = 0; i < count; i++) {
+        stats[i] = pool->workers[i].stats;
+        stats[i].wall_us = wall_us;
+    }
+    return count;
+}
+
+void wamr_worker_pool_reset_stats(WamrWorkerPool* pool) {
+    for (int i = 0; i < pool->num_workers; i++) {
+        memset(&pool->workers[i].stats, 0, sizeof(pool->workers[i].stats));
+    }
+    pool->stats_start_us = os_time_get_boot_us();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "wamr_aot_wrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Worker pool for running independent engines in parallel (Linux host build only, pthreads).
+// Each worker owns a WAMR thread env; every engine already owns its exec env, so
+// engines can run on any worker as long as one engine appears once per batch.
+
+typedef struct {
+    WamrAotEngine* engine;
+    const float* input;
+    float* output;
+    int num_samples;
+} WamrPoolJob;
+
+typedef struct {
+    uint32_t jobs;      // jobs run by this worker
+    uint32_t stolen;    // of those, jobs taken from another worker's share
+    uint64_t busy_us;   // time spent inside process()
+    uint64_t wall_us;   // time since the stats were last reset
+} WamrWorkerStats;
+
+typedef struct WamrWorkerPool WamrWorkerPool;
+
+/**
+ * Create a pool of num_workers workers. The calling thread acts as worker 0,
+ * so num_workers - 1 threads are spawned. Engines must be created beforehand.
+ */
+WamrWorkerPool* wamr_worker_pool_new(int num_workers);
+void wamr_worker_pool_delete(WamrWorkerPool* pool);
+
+/**
+ * Process one block for every job and return once all of them are done (the
+ * barrier before output mixing). Jobs are split evenly between workers; a worker
+ * that finishes its share steals from the others.
+ */
+void wamr_worker_pool_run(WamrWorkerPool* pool, const WamrPoolJob* jobs, int num_jobs);
+
+// Copy per-worker statistics into stats[0..num_workers); returns the worker count
+int wamr_worker_pool_get_stats(WamrWorkerPool* pool, WamrWorkerStats* stats, int max_workers);
+void wamr_worker_pool_reset_stats(WamrWorkerPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+#include "host_support.h"
+#include "wamr_sdram_cache.h"
+#include <stdlib.h>
+#include <time.h>
+
+int host_failures = 0;
+
+// Same hooks as src/main.cpp, with malloc/free as the core
+void* sdram_alloc(size_t size) {
+    return wamr_sdram_cache_alloc(size);
+}
+
+void sdram_dealloc(void* ptr) {
+    wamr_sdram_cache_free(ptr);
+}
+
+void* sdram_realloc(void* ptr, size_t size) {
+    return wamr_sdram_cache_realloc(ptr, size);
+}
+
+void* sdram_calloc(size_t nmemb, size_t size) {
+    return wamr_sdram_cache_calloc(nmemb, size);
+}
+
+void host_init(void) {
+    wamr_sdram_cache_init(malloc, free);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+void host_print_line(const char* line, void* ctx) {
+    (void)ctx;
+    printf("%s\n", line);
+}
+
+uint64_t host_time_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
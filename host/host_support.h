@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shared pieces of the Linux host programs: the sdram_* hooks the wrapper expects,
+// backed by malloc through the same magazine cache as the firmware, a stdout line
+// sink for the wrapper's dumps, and a check macro for the tests.
+
+// Call once before creating any engine
+void host_init(void);
+
+void host_print_line(const char* line, void* ctx);
+
+// Monotonic time in microseconds
+uint64_t host_time_us(void);
+
+// Failed HOST_CHECKs so far; a test's main returns host_failures != 0
+extern int host_failures;
+
+#define HOST_CHECK(cond)                                                      \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            host_failures++;                                                  \
+        }                                                                     \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
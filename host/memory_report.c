@@ -0,0 +1,107 @@
+#include "wamr_aot_wrapper.h"
+#include "host_support.h"
+#include "module_aot.h"
+#include "test_module.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Memory profile of each module in the set after a run of blocks, and the total
+// saved over the fixed stack + heap every module used to get. Extra .aot/.wasm
+// files can be passed on the command line. Fails if a module has no wamr.profile
+// section, since its stack can't be measured then. For a module not profiled yet,
+// prints the stack_used= / heap_peak= lines for its module.profile: the C stack
+// and app heap live in linear memory, so the x86_64 figures hold on the Daisy.
+
+#define BLOCK 128
+#define BLOCKS 256
+
+typedef struct {
+    const char* name;
+    uint8_t* image;
+    uint32_t len;
+} ModuleImage;
+
+static uint8_t* read_file(const char* path, uint32_t* len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* buf = malloc(size > 0 ? size : 1);
+    if (buf && fread(buf, 1, size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = (uint32_t)size;
+    return buf;
+}
+
+static bool report(const ModuleImage* module, WamrMemoryProfile* total) {
+    WamrTier tier = memcmp(module->image, "\0aot", 4) == 0 ? WAMR_TIER_AOT : WAMR_TIER_INTERP;
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!engine || !wamr_aot_engine_load_module(engine, module->image, module->len, tier)) {
+        printf("%-16s failed to load\n", module->name);
+        wamr_aot_engine_delete(engine);
+        return false;
+    }
+
+    float input[BLOCK], output[BLOCK];
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int i = 0; i < BLOCK; i++) input[i] = sinf((float)(b * BLOCK + i) * 0.05f);
+        wamr_aot_engine_process(engine, input, output, BLOCK);
+    }
+
+    WamrMemoryProfile profile;
+    wamr_aot_engine_get_memory_profile(engine, &profile);
+    int saved = (int)profile.legacy_size - (int)(profile.stack_size + profile.heap_size);
+    printf("%-16s %8u %8u/%-8u %8u/%-8u %10u %8d%s\n", module->name, (unsigned)profile.static_size,
+           (unsigned)profile.stack_used, (unsigned)profile.stack_size, (unsigned)profile.heap_peak,
+           (unsigned)profile.heap_size, (unsigned)profile.linear_memory, saved,
+           profile.profiled ? "" : "  (not profiled)");
+    if (!profile.profiled) {
+        printf("%-16s stack_used=%u heap_peak=%u\n", "", (unsigned)profile.stack_used, (unsigned)profile.heap_peak);
+    }
+
+    total->static_size += profile.static_size;
+    total->stack_used += profile.stack_used;
+    total->stack_size += profile.stack_size;
+    total->heap_peak += profile.heap_peak;
+    total->heap_size += profile.heap_size;
+    total->linear_memory += profile.linear_memory;
+    total->legacy_size += profile.legacy_size;
+    bool has_layout = profile.stack_size > 0;
+    wamr_aot_engine_delete(engine);
+    return has_layout;
+}
+
+int main(int argc, char** argv) {
+    host_init();
+    ModuleImage modules[16] = {
+        {"module", module_aot, module_aot_len},
+        {"test_module", test_module_aot, test_module_aot_len},
+    };
+    int count = 2;
+    for (int i = 1; i < argc && count < 16; i++) {
+        modules[count].name = argv[i];
+        modules[count].image = read_file(argv[i], &modules[count].len);
+        if (!modules[count].image || modules[count].len < 4) {
+            printf("Can't read %s\n", argv[i]);
+            return 1;
+        }
+        count++;
+    }
+
+    printf("%-16s %8s %17s %17s %10s %8s\n", "module", "static", "stack used/size", "heap peak/size",
+           "linear mem", "saved");
+    WamrMemoryProfile total = {0};
+    for (int i = 0; i < count; i++) {
+        HOST_CHECK(report(&modules[i], &total));
+    }
+    printf("%-16s %8u %8u/%-8u %8u/%-8u %10u %8d\n", "total", (unsigned)total.static_size,
+           (unsigned)total.stack_used, (unsigned)total.stack_size, (unsigned)total.heap_peak,
+           (unsigned)total.heap_size, (unsigned)total.linear_memory,
+           (int)total.legacy_size - (int)(total.stack_size + total.heap_size));
+    return host_failures != 0;
+}
@@ -0,0 +1,42 @@
+// Module for the host tests: a trivial process() that can be made arbitrarily slow,
+// and a visible quality level and sample rate. Built by add_test_module() in host/CMakeLists.txt.
+
+#define EXPORT(name) __attribute__((export_name(#name)))
+
+static volatile int spin = 0;   // LCG iterations burned per block
+static unsigned seed = 1;
+static int quality = 0;
+static float sample_rate = 0.f;  // 0 until the host calls set_sample_rate()
+
+EXPORT(set_spin) void set_spin(int iterations) {
+    spin = iterations;
+}
+
+EXPORT(set_quality) void set_quality(int level) {
+    quality = level;
+}
+
+EXPORT(get_quality) int get_quality(void) {
+    return quality;
+}
+
+EXPORT(set_sample_rate) void set_sample_rate(float rate) {
+    sample_rate = rate;
+}
+
+EXPORT(get_sample_rate) float get_sample_rate(void) {
+    return sample_rate;
+}
+
+// output = input + 0.5, after a tight loop with no calls in it, which only
+// suspend-flag polling at the loop header can interrupt
+EXPORT(process) void process(const float* input, float* output, int num_samples) {
+    unsigned x = seed;
+    for (int i = 0; i < spin; i++) {
+        x = x * 1664525u + 1013904223u;
+    }
+    seed = x;
+    for (int i = 0; i < num_samples; i++) {
+        output[i] = input[i] + 0.5f;
+    }
+}
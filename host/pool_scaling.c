@@ -0,0 +1,97 @@
+#include "wamr_worker_pool.h"
+#include "host_support.h"
+#include "module_aot.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+// Core-scaling table for the worker pool: the same set of channels, one engine
+// each, processed with 1, 2, 4, ... workers up to the core count.
+//
+//   pool_scaling [channels] [blocks]
+
+#define BLOCK 128
+#define SAMPLE_RATE 48000
+
+int main(int argc, char** argv) {
+    int channels = argc > 1 ? atoi(argv[1]) : 64;
+    int blocks = argc > 2 ? atoi(argv[2]) : 500;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 64) cores = 64;  // the pool's worker limit
+    if (cores < 1) cores = 1;
+    if (channels < 1 || blocks < 1) {
+        printf("usage: pool_scaling [channels] [blocks]\n");
+        return 1;
+    }
+    host_init();
+
+    WamrAotEngine** engines = calloc(channels, sizeof(WamrAotEngine*));
+    uint8_t** images = calloc(channels, sizeof(uint8_t*));
+    float* input = malloc(BLOCK * sizeof(float));
+    float* output = malloc((size_t)channels * BLOCK * sizeof(float));
+    WamrPoolJob* jobs = calloc(channels, sizeof(WamrPoolJob));
+    for (int i = 0; i < BLOCK; i++) input[i] = sinf(i * 0.05f);
+    for (int c = 0; c < channels; c++) {
+        // Each engine loads its own copy; the loader may patch the image in place
+        images[c] = malloc(module_aot_len);
+        memcpy(images[c], module_aot, module_aot_len);
+        engines[c] = wamr_aot_engine_new();
+        if (!engines[c] || !wamr_aot_engine_load_module(engines[c], images[c], module_aot_len, WAMR_TIER_AOT)) {
+            printf("ERROR: Failed to load channel %d\n", c);
+            return 1;
+        }
+        jobs[c] = (WamrPoolJob){engines[c], input, output + (size_t)c * BLOCK, BLOCK};
+    }
+
+    const double period_us = 1e6 * BLOCK / SAMPLE_RATE;
+    printf("%d channels, %d blocks of %d samples, %ld cores, block period %.1f us\n",
+           channels, blocks, BLOCK, cores, period_us);
+    printf("%7s %12s %12s %8s %10s %8s %8s\n", "workers", "block_avg_us", "block_max_us", "speedup",
+           "efficiency", "load", "stolen");
+
+    double single_us = 0;
+    for (int workers = 1;; workers = workers * 2 < cores ? workers * 2 : (int)cores) {
+        WamrWorkerPool* pool = wamr_worker_pool_new(workers);
+        if (!pool) {
+            printf("ERROR: Failed to start %d workers\n", workers);
+            return 1;
+        }
+        // Warm up caches and thread envs before measuring
+        for (int b = 0; b < 10; b++) wamr_worker_pool_run(pool, jobs, channels);
+        wamr_worker_pool_reset_stats(pool);
+
+        uint64_t total_us = 0, max_us = 0;
+        for (int b = 0; b < blocks; b++) {
+            uint64_t start_us = host_time_us();
+            wamr_worker_pool_run(pool, jobs, channels);
+            uint64_t elapsed_us = host_time_us() - start_us;
+            total_us += elapsed_us;
+            if (elapsed_us > max_us) max_us = elapsed_us;
+        }
+
+        WamrWorkerStats stats[64];
+        int n = wamr_worker_pool_get_stats(pool, stats, 64);
+        uint32_t stolen = 0;
+        for (int w = 0; w < n; w++) stolen += stats[w].stolen;
+
+        double avg_us = (double)total_us / blocks;
+        if (workers == 1) single_us = avg_us;
+        double speedup = single_us / avg_us;
+        printf("%7d %12.1f %12llu %8.2f %9.0f%% %7.0f%% %8u\n", workers, avg_us, (unsigned long long)max_us,
+               speedup, 100.0 * speedup / workers, 100.0 * avg_us / period_us, (unsigned)stolen);
+        wamr_worker_pool_delete(pool);
+        if (workers >= cores) break;
+    }
+
+    for (int c = 0; c < channels; c++) {
+        wamr_aot_engine_delete(engines[c]);
+        free(images[c]);
+    }
+    free(engines);
+    free(images);
+    free(input);
+    free(output);
+    free(jobs);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "wamr_sdram_bench.h"
+#include "host_support.h"
+#include <stdlib.h>
+
+// Allocator contention under background load, as CSV: locked core against
+// per-thread magazines.
+//
+//   sdram_contention [background threads] [ops per thread]
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    int ops = argc > 2 ? atoi(argv[2]) : 200000;
+    if (threads < 1 || ops < 1) {
+        printf("usage: sdram_contention [background threads] [ops per thread]\n");
+        return 1;
+    }
+    host_init();
+    wamr_sdram_bench_run(threads, ops, host_print_line, NULL);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "wamr_aot_wrapper.h"
+#include "wamr_assets.h"
+#include "wamr_log.h"
+#include "host_support.h"
+#include "module_aot.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// A multi-megabyte asset is loaded from a file once and read by several instances
+// of the demo module through its asset_read import. Every instance must see the
+// same data, and the asset must cost its size once, however many instances read it.
+
+#define ASSET_FLOATS (2 * 1024 * 1024)  // 8 MB; whole numbers stay exact as floats
+#define ASSET_BYTES (ASSET_FLOATS * (uint32_t)sizeof(float))
+#define INSTANCES 4
+#define SLICE 128
+#define READS 64
+
+typedef struct {
+    WamrAotEngine* engine;
+    uint8_t* image;  // the loader may patch the image in place
+    wasm_function_inst_t read_block;
+} Instance;
+
+// First float of the count floats the module copied from index
+static float read_block(Instance* inst, int handle, uint32_t index, int count) {
+    uint32_t argv[3] = {(uint32_t)handle, index, (uint32_t)count};
+    if (!wasm_runtime_call_wasm(inst->engine->exec_env, inst->read_block, 3, argv)) return -1.f;
+    float first;
+    memcpy(&first, argv, sizeof(first));
+    return first;
+}
+
+static bool write_asset_file(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    static float chunk[64 * 1024];
+    bool ok = true;
+    for (uint32_t base = 0; ok && base < ASSET_FLOATS; base += 64 * 1024) {
+        for (int i = 0; i < 64 * 1024; i++) chunk[i] = (float)(base + i);
+        ok = fwrite(chunk, sizeof(chunk), 1, f) == 1;
+    }
+    return fclose(f) == 0 && ok;
+}
+
+int main(void) {
+    host_init();
+
+    char path[] = "/tmp/wamr_asset_XXXXXX";
+    int fd = mkstemp(path);
+    HOST_CHECK(fd >= 0 && write_asset_file(path));
+    if (fd >= 0) close(fd);
+    if (host_failures) return 1;
+
+    // Loaded from the file once, into a buffer the registry owns
+    uint32_t owned_before = wamr_assets_bytes();
+    int handle = wamr_asset_load_file("ramp", path);
+    unlink(path);
+    HOST_CHECK(handle >= 0 && wamr_asset_find("ramp") == handle);
+    if (host_failures) return 1;
+    const WamrAsset* asset = wamr_asset_get(handle);
+    const uint8_t* data = asset->data;
+    HOST_CHECK(asset->size == ASSET_BYTES && asset->owned);
+    HOST_CHECK(wamr_assets_bytes() - owned_before == ASSET_BYTES);
+
+    // Every instance is attached to the same copy; each one adds only its own runtime memory
+    Instance instances[INSTANCES];
+    uint32_t runtime_before = wamr_aot_runtime_bytes_in_use();
+    int loaded = 0;
+    for (; loaded < INSTANCES; loaded++) {
+        Instance* inst = &instances[loaded];
+        inst->engine = wamr_aot_engine_new();
+        inst->image = malloc(module_aot_len);
+        memcpy(inst->image, module_aot, module_aot_len);
+        if (!wamr_aot_engine_load_module(inst->engine, inst->image, module_aot_len, WAMR_TIER_AOT)) break;
+        inst->read_block = wasm_runtime_lookup_function(inst->engine->instance, "read_asset_block");
+        if (!inst->read_block) break;
+    }
+    HOST_CHECK(loaded == INSTANCES);
+    uint32_t per_instance = (wamr_aot_runtime_bytes_in_use() - runtime_before) / (loaded ? loaded : 1);
+
+    // Each instance reads slices spread over the whole asset, its own and the others'
+    int mismatches = 0;
+    for (int r = 0; r < READS; r++) {
+        for (int i = 0; i < loaded; i++) {
+            uint32_t index = (uint32_t)((r * INSTANCES + i) * (uint64_t)(ASSET_FLOATS - SLICE) / (READS * INSTANCES));
+            if (read_block(&instances[i], handle, index, SLICE) != (float)index) mismatches++;
+        }
+    }
+    HOST_CHECK(mismatches == 0);
+    // Past the end the module gets zeros, not a neighbour's memory
+    HOST_CHECK(loaded == 0 || read_block(&instances[0], handle, ASSET_FLOATS, SLICE) == 0.f);
+
+    // Still one copy: nothing was duplicated per instance or per read
+    HOST_CHECK(wamr_asset_get(handle)->data == data);
+    HOST_CHECK(wamr_assets_bytes() - owned_before == ASSET_BYTES);
+    HOST_CHECK(per_instance < ASSET_BYTES / 8);
+    WamrMemoryProfile profile;
+    if (loaded) {
+        wamr_aot_engine_get_memory_profile(instances[0].engine, &profile);
+        HOST_CHECK(profile.linear_memory < ASSET_BYTES / 8);
+    }
+    printf("%d instances sharing a %u KB asset: %u KB runtime each, %d bad reads\n", loaded,
+           (unsigned)(ASSET_BYTES >> 10), (unsigned)(per_instance >> 10), mismatches);
+
+    // In-memory data is copied once at load; the source can go away
+    float* source = malloc(SLICE * sizeof(float));
+    for (int i = 0; i < SLICE; i++) source[i] = 1000.f + i;
+    int copy = wamr_asset_load("copy", source, SLICE * sizeof(float));
+    HOST_CHECK(copy >= 0 && wamr_asset_get(copy)->data != (const uint8_t*)source);
+    memset(source, 0, SLICE * sizeof(float));
+    free(source);
+    for (int i = 0; copy >= 0 && i < loaded; i++) {
+        HOST_CHECK(read_block(&instances[i], copy, 5, 4) == 1005.f);
+    }
+    wamr_asset_remove(copy);
+    HOST_CHECK(wamr_assets_bytes() - owned_before == ASSET_BYTES);
+
+    // Includes the instance that failed to load, if any
+    for (int i = 0; i < INSTANCES && i <= loaded; i++) {
+        wamr_aot_engine_delete(instances[i].engine);
+        free(instances[i].image);
+    }
+    wamr_asset_remove(handle);
+    HOST_CHECK(wamr_assets_bytes() == owned_before);
+    wamr_log_drain(host_print_line, NULL);
+    printf("%s\n", host_failures ? "FAILED" : "PASSED");
+    return host_failures != 0;
+}
@@ -0,0 +1,200 @@
+#include "wamr_aot_wrapper.h"
+#include "wamr_log.h"
+#include "host_support.h"
+#include "test_module.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A module stuck in a tight loop must be stopped by the deadline watchdog within
+// a fraction of a millisecond of its budget, output the fallback until the main
+// loop re-instantiates it, and be bypassed after too many strikes in a row. The
+// audio path keeps writing its output while the main loop is halfway through
+// replacing the instance, and the replacement runs at the same rate as the original.
+
+#define BLOCK 64
+#define BUDGET_US 2000
+#define STOP_LIMIT_US 50000  // generous: the watchdog thread may be preempted on a loaded host
+#define MAX_STRIKES 8        // WAMR_DEADLINE_MAX_STRIKES in the wrapper
+#define RACE_ROUNDS 20       // runaway calls recovered while the audio thread keeps running
+#define RACE_CLEAN_BLOCKS 4  // normal blocks between runaways, well under MAX_STRIKES
+
+static void set_spin(WamrAotEngine* engine, int iterations) {
+    wasm_function_inst_t func = wasm_runtime_lookup_function(engine->instance, "set_spin");
+    uint32_t argv[1] = {(uint32_t)iterations};
+    HOST_CHECK(func && wasm_runtime_call_wasm(engine->exec_env, func, 1, argv));
+}
+
+// Process one block of 1.0 and return the first output sample
+static float run_block(WamrAotEngine* engine) {
+    float input[BLOCK], output[BLOCK];
+    for (int i = 0; i < BLOCK; i++) input[i] = 1.f;
+    memset(output, 0xFF, sizeof(output));
+    wamr_aot_engine_process(engine, input, output, BLOCK);
+    return output[0];
+}
+
+static float module_rate(WamrAotEngine* engine) {
+    wasm_function_inst_t func = wasm_runtime_lookup_function(engine->instance, "get_sample_rate");
+    uint32_t argv[1] = {0};
+    HOST_CHECK(func && wasm_runtime_call_wasm(engine->exec_env, func, 0, argv));
+    float rate;
+    memcpy(&rate, argv, sizeof(rate));
+    return rate;
+}
+
+typedef struct {
+    WamrAotEngine* engine;
+    int rounds;        // runaway calls started by the audio thread
+    int bad;           // blocks whose output was neither the module's nor the fallback
+    atomic_bool done;  // read by the main thread; bad is read only after the join
+} RaceState;
+
+// Audio thread: process blocks back to back, and every few clean blocks send the
+// module into a runaway loop. Only this thread calls into the instance, and only
+// while it isn't waiting for recovery, so the main thread is free to replace it.
+static void* race_audio_thread(void* arg) {
+    RaceState* state = arg;
+    int clean = 0;
+    while (state->rounds < RACE_ROUNDS) {
+        float out = run_block(state->engine);
+        if (out != 1.5f && out != 0.f) state->bad++;
+        if (wamr_aot_engine_needs_recovery(state->engine)) continue;
+        if (++clean >= RACE_CLEAN_BLOCKS) {
+            set_spin(state->engine, 0x7FFFFFFF);
+            state->rounds++;
+            clean = 0;
+        }
+    }
+    // Run the last runaway and let the main thread recover it
+    do {
+        float out = run_block(state->engine);
+        if (out != 1.5f && out != 0.f) state->bad++;
+    } while (wamr_aot_engine_needs_recovery(state->engine));
+    atomic_store(&state->done, true);
+    return NULL;
+}
+
+// process() between destroy_instance() and instantiate_module() must still write the fallback
+static void test_recover_race(WamrAotEngine* engine) {
+    const WamrDeadlineStats* stats = wamr_aot_engine_get_deadline_stats(engine);
+    uint32_t recoveries_before = stats->recoveries;
+    RaceState state = {engine, 0, 0, false};
+    pthread_t audio;
+    HOST_CHECK(pthread_create(&audio, NULL, race_audio_thread, &state) == 0);
+    while (!atomic_load(&state.done)) {
+        if (wamr_aot_engine_needs_recovery(engine)) HOST_CHECK(wamr_aot_engine_recover(engine));
+    }
+    pthread_join(audio, NULL);
+    printf("recover race: %u recoveries, %d bad blocks\n", stats->recoveries - recoveries_before, state.bad);
+    HOST_CHECK(state.bad == 0);
+    HOST_CHECK(stats->recoveries - recoveries_before == RACE_ROUNDS);
+    HOST_CHECK(!engine->bypassed);
+}
+
+// A recovered instance is told the rate it runs at, not left at the module's default
+static void test_recovered_rate(WamrTier tier, const uint8_t* image, uint32_t len) {
+    uint8_t* buf = malloc(len);
+    memcpy(buf, image, len);
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    HOST_CHECK(engine && wamr_aot_engine_load_module(engine, buf, len, tier));
+    if (host_failures) return;
+    HOST_CHECK(wamr_aot_engine_set_deadline(engine, BUDGET_US, WAMR_FALLBACK_SILENCE, BLOCK));
+
+    wamr_aot_engine_set_sample_rate(engine, 44100.f);
+    HOST_CHECK(wamr_aot_engine_set_stream(engine, BLOCK, 0, 2) >= 0);
+    HOST_CHECK(module_rate(engine) == 22050.f);
+
+    // Terminated inside the stream, then replaced
+    set_spin(engine, 0x7FFFFFFF);
+    run_block(engine);
+    HOST_CHECK(wamr_aot_engine_needs_recovery(engine));
+    HOST_CHECK(wamr_aot_engine_recover(engine));
+    printf("rate after recovery: %.0f Hz\n", module_rate(engine));
+    HOST_CHECK(module_rate(engine) == 22050.f);
+
+    // A rate change while the instance waits for recovery reaches the replacement
+    set_spin(engine, 0x7FFFFFFF);
+    run_block(engine);
+    HOST_CHECK(wamr_aot_engine_needs_recovery(engine));
+    wamr_aot_engine_set_stream(engine, 0, 0, 0);
+    HOST_CHECK(wamr_aot_engine_recover(engine));
+    HOST_CHECK(module_rate(engine) == 44100.f);
+
+    wamr_aot_engine_delete(engine);
+    free(buf);
+    wamr_log_drain(host_print_line, NULL);
+}
+
+static void test_tier(WamrTier tier, const uint8_t* image, uint32_t len) {
+    if (!wamr_tier_supported(tier)) return;
+    printf("--- %s ---\n", wamr_tier_name(tier));
+
+    // The loader may patch the image in place
+    uint8_t* buf = malloc(len);
+    memcpy(buf, image, len);
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    HOST_CHECK(engine && wamr_aot_engine_load_module(engine, buf, len, tier));
+    if (host_failures) return;
+    HOST_CHECK(wamr_aot_engine_set_deadline(engine, BUDGET_US, WAMR_FALLBACK_SILENCE, BLOCK));
+    const WamrDeadlineStats* stats = wamr_aot_engine_get_deadline_stats(engine);
+
+    // Within budget: the module's own output
+    HOST_CHECK(run_block(engine) == 1.5f);
+    HOST_CHECK(stats->terminations == 0 && !wamr_aot_engine_needs_recovery(engine));
+
+    // Runaway: terminated close to the budget, silence, instance marked for recovery
+    set_spin(engine, 0x7FFFFFFF);
+    HOST_CHECK(run_block(engine) == 0.f);
+    printf("runaway call stopped after %u us (budget %u us)\n", stats->last_us, BUDGET_US);
+    HOST_CHECK(stats->terminations == 1);
+    HOST_CHECK(stats->last_us < STOP_LIMIT_US);
+    HOST_CHECK(wamr_aot_engine_needs_recovery(engine));
+
+    // The instance isn't called again until it is replaced
+    HOST_CHECK(run_block(engine) == 0.f);
+    HOST_CHECK(stats->calls == 2);
+
+    // A fresh instance starts from the module's initial state (spin = 0)
+    HOST_CHECK(wamr_aot_engine_recover(engine));
+    HOST_CHECK(!wamr_aot_engine_needs_recovery(engine) && stats->recoveries == 1);
+    HOST_CHECK(run_block(engine) == 1.5f);
+
+    // Strikes in a row bypass the module even though every instance is recovered
+    wamr_aot_engine_reset_deadline(engine);
+    for (int strike = 0; strike < MAX_STRIKES; strike++) {
+        set_spin(engine, 0x7FFFFFFF);
+        run_block(engine);
+        HOST_CHECK(wamr_aot_engine_recover(engine));
+    }
+    HOST_CHECK(stats->terminations == MAX_STRIKES);
+    HOST_CHECK(run_block(engine) == 0.f);
+    HOST_CHECK(stats->calls == MAX_STRIKES);
+
+    // Re-enabled by the host
+    wamr_aot_engine_reset_deadline(engine);
+    HOST_CHECK(run_block(engine) == 1.5f);
+
+    // Recovery racing the audio thread
+    test_recover_race(engine);
+    HOST_CHECK(run_block(engine) == 1.5f);
+
+    // No instance at all: silence rather than whatever the buffer held
+    wamr_aot_engine_unload_module(engine);
+    HOST_CHECK(run_block(engine) == 0.f);
+
+    wamr_aot_engine_delete(engine);
+    free(buf);
+    wamr_log_drain(host_print_line, NULL);
+
+    test_recovered_rate(tier, image, len);
+}
+
+int main(void) {
+    host_init();
+    test_tier(WAMR_TIER_AOT, test_module_aot, test_module_aot_len);
+    test_tier(WAMR_TIER_INTERP, test_module_wasm, test_module_wasm_len);
+    printf("%s\n", host_failures ? "FAILED" : "PASSED");
+    return host_failures != 0;
+}
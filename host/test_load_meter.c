@@ -0,0 +1,84 @@
+#include "wamr_load_meter.h"
+#include "host_support.h"
+
+// Step the load across the meter's thresholds and check every quality transition:
+// one level per change, never closer together than the dwell, shedding only above
+// degrade_above or on an overrun, restoring only below restore_below, and holding
+// still in between.
+
+#define PERIOD_US 1000
+#define DEGRADE_ABOVE 0.7f
+#define RESTORE_BELOW 0.4f
+
+typedef struct {
+    int changes;       // transitions in this run
+    int first_block;   // block of the first transition, -1 if none
+} RunResult;
+
+static uint32_t block_index = 0;
+static uint32_t last_change = 0;
+
+// Feed blocks at a constant load (percent of the period), checking each transition
+// the way the engine would signal it to set_quality()
+static RunResult run(WamrLoadMeter* meter, int load_percent, int blocks) {
+    RunResult result = {0, -1};
+    for (int i = 0; i < blocks; i++) {
+        int before = meter->quality;
+        block_index++;
+        if (!wamr_load_meter_update(meter, (uint32_t)(load_percent * PERIOD_US / 100), PERIOD_US)) {
+            HOST_CHECK(meter->quality == before);
+            continue;
+        }
+        int step = meter->quality - before;
+        HOST_CHECK(step == 1 || step == -1);
+        HOST_CHECK(meter->quality >= 0 && meter->quality < WAMR_QUALITY_LEVELS);
+        if (last_change) HOST_CHECK(block_index - last_change > WAMR_QUALITY_DWELL_BLOCKS);
+        if (step > 0) HOST_CHECK(meter->block_load >= 1.f || meter->smoothed > DEGRADE_ABOVE);
+        if (step < 0) HOST_CHECK(meter->smoothed < RESTORE_BELOW);
+        printf("block %4u: load %3d%%, smoothed %.2f -> quality %d\n", (unsigned)block_index, load_percent,
+               meter->smoothed, meter->quality);
+        last_change = block_index;
+        if (result.first_block < 0) result.first_block = i;
+        result.changes++;
+    }
+    return result;
+}
+
+int main(void) {
+    WamrLoadMeter meter;
+    wamr_load_meter_init(&meter, DEGRADE_ABOVE, RESTORE_BELOW);
+
+    // Comfortable load: full quality throughout
+    RunResult r = run(&meter, 50, 200);
+    HOST_CHECK(r.changes == 0 && meter.quality == 0);
+
+    // Above degrade_above: the smoothed load takes a while to cross, then one
+    // level is shed per dwell until the lowest quality, where it stays
+    r = run(&meter, 85, 400);
+    HOST_CHECK(r.first_block > 0);
+    HOST_CHECK(r.changes == WAMR_QUALITY_LEVELS - 1);
+    HOST_CHECK(meter.quality == WAMR_QUALITY_LEVELS - 1);
+
+    // Between the thresholds: hysteresis holds the level
+    r = run(&meter, 55, 400);
+    HOST_CHECK(r.changes == 0 && meter.quality == WAMR_QUALITY_LEVELS - 1);
+
+    // Below restore_below: levels come back one per dwell, down to full quality
+    r = run(&meter, 20, 400);
+    HOST_CHECK(r.first_block > 0);
+    HOST_CHECK(r.changes == WAMR_QUALITY_LEVELS - 1);
+    HOST_CHECK(meter.quality == 0);
+
+    // A single overrun sheds a level on that very block, before the average moves
+    r = run(&meter, 120, 1);
+    HOST_CHECK(r.changes == 1 && meter.quality == 1);
+    HOST_CHECK(meter.smoothed < DEGRADE_ABOVE);
+
+    // ...and is restored once the dwell has run out
+    r = run(&meter, 20, 100);
+    HOST_CHECK(r.changes == 1 && meter.quality == 0);
+    HOST_CHECK(meter.quality_changes == 2 * (WAMR_QUALITY_LEVELS - 1) + 2);
+
+    printf("%s\n", host_failures ? "FAILED" : "PASSED");
+    return host_failures != 0;
+}
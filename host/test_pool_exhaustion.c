@@ -0,0 +1,124 @@
+#include "wamr_aot_wrapper.h"
+#include "wamr_log.h"
+#include "host_support.h"
+#include "test_module.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Static pool mode (built with WAMR_POOL_SIZE): loading instances until the pool
+// runs out must fail cleanly, leave the instances already loaded working, and give
+// every byte back once they are released. Memory recycled inside the pool must come
+// back zeroed, like the SDRAM hooks' calloc. Module arenas are refused.
+
+#define BLOCK 64
+#define MAX_ENGINES 64
+#define TAIL_BYTES 1024  // end of linear memory, which neither the module nor WAMR writes
+
+typedef struct {
+    WamrAotEngine* engine;
+    uint8_t* image;  // the loader may patch the image in place
+} Instance;
+
+static bool load(Instance* inst) {
+    inst->engine = wamr_aot_engine_new();
+    inst->image = malloc(test_module_aot_len);
+    if (!inst->engine || !inst->image) return false;
+    memcpy(inst->image, test_module_aot, test_module_aot_len);
+    return wamr_aot_engine_load_module(inst->engine, inst->image, test_module_aot_len, WAMR_TIER_AOT);
+}
+
+static void release(Instance* inst) {
+    wamr_aot_engine_delete(inst->engine);
+    free(inst->image);
+}
+
+static uint8_t* memory_tail(WamrAotEngine* engine) {
+    WamrMemoryProfile profile;
+    wamr_aot_engine_get_memory_profile(engine, &profile);
+    if (profile.linear_memory < TAIL_BYTES) return NULL;
+    return wasm_runtime_addr_app_to_native(engine->instance, profile.linear_memory - TAIL_BYTES);
+}
+
+static float run_block(WamrAotEngine* engine) {
+    float input[BLOCK], output[BLOCK];
+    for (int i = 0; i < BLOCK; i++) input[i] = 1.f;
+    memset(output, 0xFF, sizeof(output));
+    wamr_aot_engine_process(engine, input, output, BLOCK);
+    return output[0];
+}
+
+int main(void) {
+    host_init();
+
+    // The first instance keeps the runtime, and with it the pool, alive throughout
+    Instance anchor;
+    HOST_CHECK(load(&anchor));
+    WamrPoolInfo pool;
+    HOST_CHECK(wamr_aot_runtime_pool_info(&pool));
+    if (host_failures) return 1;
+    printf("pool: %u bytes, %u in use with one instance\n", (unsigned)pool.size, (unsigned)pool.used);
+
+    // Arenas would be carved from the pool for nothing; they are refused, not ignored
+    HOST_CHECK(!wamr_aot_engine_set_arena(anchor.engine, 64 * 1024));
+    HOST_CHECK(wamr_aot_engine_set_arena(anchor.engine, 0));
+
+    // Dirty the instance's memory, then reload: the new instance gets recycled pool
+    // memory, which must read as zero
+    uint8_t* tail = memory_tail(anchor.engine);
+    HOST_CHECK(tail);
+    if (tail) memset(tail, 0x5A, TAIL_BYTES);
+    wamr_aot_engine_unload_module(anchor.engine);
+    memcpy(anchor.image, test_module_aot, test_module_aot_len);
+    HOST_CHECK(wamr_aot_engine_load_module(anchor.engine, anchor.image, test_module_aot_len, WAMR_TIER_AOT));
+    tail = memory_tail(anchor.engine);
+    HOST_CHECK(tail);
+    for (int i = 0; tail && i < TAIL_BYTES; i++) {
+        if (tail[i]) {
+            printf("byte %d of the recycled tail is 0x%02x\n", i, tail[i]);
+            HOST_CHECK(tail[i] == 0);
+            break;
+        }
+    }
+    HOST_CHECK(run_block(anchor.engine) == 1.5f);
+
+    HOST_CHECK(wamr_aot_runtime_pool_info(&pool));
+    uint32_t baseline = pool.used;
+
+    // Load until the pool is exhausted
+    Instance extra[MAX_ENGINES];
+    int loaded = 0;
+    while (loaded < MAX_ENGINES) {
+        if (!load(&extra[loaded])) {
+            release(&extra[loaded]);
+            break;
+        }
+        loaded++;
+    }
+    HOST_CHECK(wamr_aot_runtime_pool_info(&pool));
+    printf("extra instances before exhaustion: %d, high-water %u of %u bytes\n", loaded,
+           (unsigned)pool.high_water, (unsigned)pool.size);
+    HOST_CHECK(loaded < MAX_ENGINES);
+    HOST_CHECK(pool.high_water <= pool.size);
+
+    // Everything loaded before the failure still runs
+    HOST_CHECK(run_block(anchor.engine) == 1.5f);
+    for (int i = 0; i < loaded; i++) {
+        HOST_CHECK(run_block(extra[i].engine) == 1.5f);
+    }
+
+    // Releasing them returns the pool to where it was, and it can be filled again
+    for (int i = 0; i < loaded; i++) release(&extra[i]);
+    HOST_CHECK(wamr_aot_runtime_pool_info(&pool));
+    printf("in use after release: %u bytes (was %u)\n", (unsigned)pool.used, (unsigned)baseline);
+    HOST_CHECK(pool.used == baseline);
+    if (loaded > 0) {
+        HOST_CHECK(load(&extra[0]));
+        HOST_CHECK(run_block(extra[0].engine) == 1.5f);
+        release(&extra[0]);
+    }
+
+    release(&anchor);
+    wamr_log_drain(host_print_line, NULL);
+    printf("%s\n", host_failures ? "FAILED" : "PASSED");
+    return host_failures != 0;
+}
@@ -0,0 +1,88 @@
+#include "wamr_aot_wrapper.h"
+#include "wamr_log.h"
+#include "host_support.h"
+#include "test_module.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Drive an engine's load across the meter's thresholds with synthetic load and
+// check that the module's set_quality export follows every transition: shedding
+// under load, carrying over to a recovered instance, and restoring when the load
+// goes away.
+
+#define BLOCK 64
+#define SAMPLE_RATE 48000
+#define PERIOD_US (BLOCK * 1000000 / SAMPLE_RATE)
+#define BLOCKS 400
+
+static int module_quality(WamrAotEngine* engine) {
+    wasm_function_inst_t func = wasm_runtime_lookup_function(engine->instance, "get_quality");
+    uint32_t argv[1] = {0};
+    HOST_CHECK(func && wasm_runtime_call_wasm(engine->exec_env, func, 0, argv));
+    return (int)argv[0];
+}
+
+// Run blocks with extra_us of synthetic load; returns the quality changes seen
+static int run(WamrAotEngine* engine, uint32_t extra_us, int blocks) {
+    float input[BLOCK] = {0}, output[BLOCK];
+    const WamrLoadMeter* load = wamr_aot_engine_get_load(engine);
+    uint32_t changes_before = load->quality_changes;
+    wamr_aot_engine_set_synthetic_load(engine, extra_us);
+    for (int i = 0; i < blocks; i++) {
+        wamr_aot_engine_process(engine, input, output, BLOCK);
+        // The module hears about every level the meter settles on
+        HOST_CHECK(module_quality(engine) == load->quality);
+    }
+    wamr_aot_engine_set_synthetic_load(engine, 0);
+    return (int)(load->quality_changes - changes_before);
+}
+
+int main(void) {
+    host_init();
+
+    uint8_t* image = malloc(test_module_aot_len);
+    memcpy(image, test_module_aot, test_module_aot_len);
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    HOST_CHECK(engine && wamr_aot_engine_load_module(engine, image, test_module_aot_len, WAMR_TIER_AOT));
+    if (host_failures) return 1;
+    wamr_aot_engine_set_load_meter(engine, SAMPLE_RATE, 0.7f, 0.4f);
+    const WamrLoadMeter* load = wamr_aot_engine_get_load(engine);
+
+    // Idle: full quality
+    HOST_CHECK(run(engine, 0, BLOCKS) == 0);
+    HOST_CHECK(load->quality == 0 && module_quality(engine) == 0);
+
+    // About 90% of the period: every level is shed, down to the lowest
+    int changes = run(engine, PERIOD_US * 9 / 10, BLOCKS);
+    printf("under load: %d changes, quality %d, smoothed %.2f\n", changes, load->quality, load->smoothed);
+    HOST_CHECK(changes >= WAMR_QUALITY_LEVELS - 1);
+    HOST_CHECK(load->quality == WAMR_QUALITY_LEVELS - 1);
+
+    // A runaway call is terminated; the replacement instance starts at full quality
+    // and must be told the current level
+    HOST_CHECK(wamr_aot_engine_set_deadline(engine, 2000, WAMR_FALLBACK_SILENCE, BLOCK));
+    wasm_function_inst_t spin = wasm_runtime_lookup_function(engine->instance, "set_spin");
+    uint32_t argv[1] = {0x7FFFFFFF};
+    HOST_CHECK(spin && wasm_runtime_call_wasm(engine->exec_env, spin, 1, argv));
+    float input[BLOCK] = {0}, output[BLOCK];
+    wamr_aot_engine_process(engine, input, output, BLOCK);
+    HOST_CHECK(wamr_aot_engine_needs_recovery(engine));
+    HOST_CHECK(wamr_aot_engine_recover(engine));
+    HOST_CHECK(module_quality(engine) == load->quality);
+
+    // Load gone: every level is restored
+    changes = run(engine, 0, BLOCKS);
+    printf("idle again: %d changes, quality %d, smoothed %.2f\n", changes, load->quality, load->smoothed);
+    HOST_CHECK(changes >= WAMR_QUALITY_LEVELS - 1);
+    HOST_CHECK(load->quality == 0 && module_quality(engine) == 0);
+
+    // Every call went through the scheduler's accounting as its own entry point
+    const WamrEntryStats* stats = wamr_aot_engine_get_entry_stats(engine, WAMR_ENTRY_QUALITY);
+    HOST_CHECK(stats->calls > 0 && stats->errors == 0);
+
+    wamr_aot_engine_delete(engine);
+    free(image);
+    wamr_log_drain(host_print_line, NULL);
+    printf("%s\n", host_failures ? "FAILED" : "PASSED");
+    return host_failures != 0;
+}
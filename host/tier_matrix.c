@@ -0,0 +1,23 @@
+#include "wamr_tier_bench.h"
+#include "host_support.h"
+#include "module_aot.h"
+#include "module_wasm.h"
+#include "test_module.h"
+#include <stdlib.h>
+
+// Every module on every tier this runtime was built with, as CSV.
+//
+//   tier_matrix [blocks]
+
+#define BLOCK 128
+
+int main(int argc, char** argv) {
+    int blocks = argc > 1 ? atoi(argv[1]) : 1000;
+    host_init();
+    const WamrBenchModule modules[] = {
+        {"module", module_wasm, module_wasm_len, module_aot, module_aot_len},
+        {"test_module", test_module_wasm, test_module_wasm_len, test_module_aot, test_module_aot_len},
+    };
+    wamr_tier_bench_run(modules, sizeof(modules) / sizeof(modules[0]), blocks, BLOCK, host_print_line, NULL);
+    return 0;
+}
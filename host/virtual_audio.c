@@ -0,0 +1,54 @@
+#include "virtual_audio_device.h"
+#include "wamr_audio.h"
+#include "wamr_log.h"
+#include "host_support.h"
+#include "module_aot.h"
+#include <stdlib.h>
+
+// The firmware's audio callback and demo module on the virtual audio device, with
+// the same deadline watchdog as on the Daisy, followed by the latency/load report.
+//
+//   virtual_audio [blocks] [block size] [sample rate]
+
+#define DEADLINE_FRACTION 0.75  // of the block period, like DEADLINE_US in main.cpp
+#define LOAD_DEGRADE_ABOVE 0.75f
+#define LOAD_RESTORE_BELOW 0.5f
+
+int main(int argc, char** argv) {
+    VirtualAudioConfig config = {
+        .sample_rate = argc > 3 ? (uint32_t)atoi(argv[3]) : 48000,
+        .block_size = argc > 2 ? (uint32_t)atoi(argv[2]) : 128,
+        .num_blocks = argc > 1 ? (uint32_t)atoi(argv[1]) : 1875,  // 5 s at 48 kHz / 128
+        .rt_priority = 80,
+        .input = VIRTUAL_INPUT_SINE,
+        .frequency = 440.f,
+        .amplitude = 0.5f,
+    };
+    if (!config.sample_rate || !config.block_size || !config.num_blocks) {
+        printf("usage: virtual_audio [blocks] [block size] [sample rate]\n");
+        return 1;
+    }
+    host_init();
+
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!engine || !wamr_aot_engine_load_module(engine, module_aot, module_aot_len, WAMR_TIER_AOT)) {
+        printf("ERROR: Failed to load the demo module\n");
+        return 1;
+    }
+    uint32_t budget_us = (uint32_t)(DEADLINE_FRACTION * 1e6 * config.block_size / config.sample_rate);
+    wamr_aot_engine_set_deadline(engine, budget_us, WAMR_FALLBACK_LAST_GOOD, config.block_size);
+    wamr_aot_engine_set_load_meter(engine, config.sample_rate, LOAD_DEGRADE_ABOVE, LOAD_RESTORE_BELOW);
+
+    wamr_audio_set_engine(engine);
+    VirtualAudioStats stats;
+    bool ok = virtual_audio_run(&config, wamr_audio_callback, &stats);
+    wamr_audio_set_engine(NULL);
+    wamr_log_drain(host_print_line, NULL);
+    if (ok) virtual_audio_report(&config, &stats, host_print_line, NULL);
+
+    const WamrDeadlineStats* deadline = wamr_aot_engine_get_deadline_stats(engine);
+    printf("Deadline: %u us budget, %u overruns, worst %u us\n", (unsigned)budget_us,
+           (unsigned)deadline->overruns, (unsigned)deadline->worst_us);
+    wamr_aot_engine_delete(engine);
+    return ok ? 0 : 1;
+}
@@ -489,6 +489,25 @@ public:
 
   }
 
+public:
+  /**
+   * @brief Summarize the free list, for measuring fragmentation
+   *
+   * @param freeBlocks Number of free blocks
+   * @param largestFree Size in bytes of the largest free block
+   * @param totalFree Total free bytes across all blocks
+   */
+  void getFreeStats(unsigned int& freeBlocks, unsigned int& largestFree, unsigned int& totalFree) {
+    freeBlocks = 0;
+    largestFree = 0;
+    totalFree = 0;
+    for (metadata* pCurrentStruct = this->freeSectionsListHeadPointer; pCurrentStruct; pCurrentStruct = pCurrentStruct->next) {
+      freeBlocks++;
+      totalFree += pCurrentStruct->size;
+      if (pCurrentStruct->size > largestFree) { largestFree = pCurrentStruct->size; }
+    }
+  }
+
 public: //TODO: This needs to be private in production, public now for testing code while running
   void PrintSDRAMFreeList() {
     // Loops through linked list
@@ -8,6 +8,10 @@ extern "C" {
 
 // Daisy WAMR Wrapper
 #include "../daisy-wrapper/wamr_aot_wrapper.h"
+#include "../daisy-wrapper/wamr_log.h"
+#include "../daisy-wrapper/wamr_assets.h"
+#include "../daisy-wrapper/wamr_sdram_cache.h"
+#include "../daisy-wrapper/wamr_audio.h"
 
 using namespace daisy;
 static DaisySeed hardware;
@@ -18,6 +22,10 @@ static Jaffx::SDRAM sdram;
 // WAMR runtime engine
 static WamrAotEngine* wamr_engine = nullptr;
 
+// Startup timing of the runtime and the embedded module
+static float boot_us = 0.0f;
+static float instantiate_us = 0.0f;
+
 // Macro for halting on errors
 #define ERROR_HALT while (true) {}
 
@@ -27,22 +35,86 @@ static WamrAotEngine* wamr_engine = nullptr;
 // Macro for enabling audio
 // #define RUN_AUDIO
 
-// C wrapper functions for WAMR platform to use SDRAM
+// Macro for enabling the instantiate/teardown allocator benchmark
+// #define BENCH_ARENA
+
+// Macro for enabling the dense event stream benchmark
+// #define BENCH_EVENTS
+
+// Macro for enabling the 24 kHz vs 48 kHz internal-rate benchmark
+// #define BENCH_REBLOCK
+
+// Macro for enabling the shared SDRAM asset benchmark
+// #define BENCH_ASSETS
+
+// Macro for enabling the spread vs naive frame processing benchmark
+// #define BENCH_FRAMES
+
+// Per-block execution budget for process(): 75% of the 128-sample period at 48kHz
+#define DEADLINE_US 2000
+
+// Smoothed load that sheds / restores one module quality level
+#define LOAD_DEGRADE_ABOVE 0.75f
+#define LOAD_RESTORE_BELOW 0.5f
+
+// Core of the SDRAM allocator; only ever called under the cache's lock
+static void* SdramCoreAlloc(size_t size) {
+    return sdram.malloc(size);
+}
+
+static void SdramCoreFree(void* ptr) {
+    sdram.free(ptr);
+}
+
+// C wrapper functions for WAMR platform to use SDRAM. They go through per-context
+// magazines, so the audio interrupt and the main loop can allocate at the same time.
 extern "C" {
     void* sdram_alloc(size_t size) {
-        return sdram.malloc(size);
+        return wamr_sdram_cache_alloc(size);
     }
     
     void sdram_dealloc(void* ptr) {
-        if (ptr) sdram.free(ptr);
+        wamr_sdram_cache_free(ptr);
     }
     
     void* sdram_realloc(void* ptr, size_t size) {
-        return sdram.realloc(ptr, size);
+        return wamr_sdram_cache_realloc(ptr, size);
     }
     
     void* sdram_calloc(size_t nmemb, size_t size) {
-        return sdram.calloc(nmemb, size);
+        return wamr_sdram_cache_calloc(nmemb, size);
+    }
+}
+
+// Deadline watchdog: one-shot TIM5 interrupt that terminates an overrunning process() call.
+// TIM5 runs at a higher NVIC priority than the SAI DMA interrupt so it can preempt the
+// audio callback.
+static TimerHandle deadline_timer;
+
+static void DeadlineTimerCallback(void* data) {
+    deadline_timer.Stop();
+    wamr_aot_engine_deadline_expired((WamrAotEngine*)data);
+}
+
+void InitDeadlineTimer() {
+    TimerHandle::Config cfg;
+    cfg.periph = TimerHandle::Config::Peripheral::TIM_5;
+    cfg.dir = TimerHandle::Config::CounterDir::UP;
+    cfg.enable_irq = true;
+    deadline_timer.Init(cfg);
+    HAL_NVIC_SetPriority(TIM5_IRQn, 0, 0);
+}
+
+extern "C" {
+    void wamr_deadline_arm(WamrAotEngine* engine, uint32_t budget_us) {
+        deadline_timer.SetCallback(DeadlineTimerCallback, engine);
+        deadline_timer.SetPeriod(budget_us * (deadline_timer.GetFreq() / 1000000));
+        TIM5->CNT = 0;
+        deadline_timer.Start();
+    }
+
+    void wamr_deadline_disarm(void) {
+        deadline_timer.Stop();
     }
 }
 
@@ -94,7 +166,11 @@ bool InitWAMR() {
     hardware.PrintLine("Initializing WAMR runtime with Daisy wrapper...");
 
     // Create WAMR engine (uses SDRAM allocator internally)
+    Timer boot_timer;
+    boot_timer.start();
     wamr_engine = wamr_aot_engine_new();
+    boot_timer.end();
+    boot_us = boot_timer.usElapsed();
     if (!wamr_engine) {
         hardware.PrintLine("ERROR: Failed to create WAMR engine");
         ERROR_HALT
@@ -105,7 +181,12 @@ bool InitWAMR() {
     // Load embedded AOT module
     hardware.PrintLine("Loading embedded AOT module...");
 
-    if (!wamr_aot_engine_load_embedded_module(wamr_engine)) {
+    Timer instantiate_timer;
+    instantiate_timer.start();
+    bool loaded = wamr_aot_engine_load_embedded_module(wamr_engine);
+    instantiate_timer.end();
+    instantiate_us = instantiate_timer.usElapsed();
+    if (!loaded) {
         hardware.PrintLine("ERROR: Failed to load embedded AOT module");
         wamr_aot_engine_delete(wamr_engine);
         wamr_engine = nullptr;
@@ -114,31 +195,6 @@ bool InitWAMR() {
 
     hardware.PrintLine("Embedded AOT module loaded and instantiated");
 
-    // CRITICAL: Zero-initialize WASM static data region
-    // Background: AOT-compiled WASM modules don't automatically zero-initialize
-    // their linear memory's BSS section. C++ function-local static variables
-    // rely on zero-initialized guard bytes to trigger proper initialization.
-    // Solution: Zero the first 8KB of linear memory (generous coverage of static data)
-    // This works generically for any WASM module without hardcoded addresses.
-    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(wamr_engine->exec_env);
-    wasm_memory_inst_t memory = wasm_runtime_get_default_memory(module_inst);
-
-    if (memory) {
-        void* mem_base = wasm_memory_get_base_address(memory);
-
-        if (mem_base) {
-            const uint32_t static_region_size = 8192;  // 8KB covers static data for most modules
-            memset(mem_base, 0, static_region_size);
-            hardware.PrintLine("WASM static region zeroed (%d bytes in SDRAM)", static_region_size);
-        } else {
-            hardware.PrintLine("ERROR: Could not get memory base address");
-            ERROR_HALT
-        }
-    } else {
-        hardware.PrintLine("ERROR: Could not get default memory instance");
-        ERROR_HALT
-    }
-
     hardware.PrintLine("Function resolved: process(float*, float*, int)");
 
     // WAMR initialized successfully!
@@ -149,14 +205,379 @@ bool InitWAMR() {
     return true;
 }
 
-// Audio callback using buffer-based WAMR processing
-static void AudioCallback(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size) {
-    // Process the entire buffer at once using the WAMR wrapper
-    wamr_aot_engine_process(wamr_engine, in[0], out[0], size);
+// Line sink for wrapper dumps
+static void PrintLineSink(const char* line, void* ctx) {
+    hardware.PrintLine("%s", line);
+}
+
+#ifdef BENCH_ARENA
+/**
+ * Time load/instantiate/teardown cycles of the embedded module and report SDRAM
+ * fragmentation afterwards, with arena_size == 0 (per-allocation SDRAM) or an arena
+ */
+void BenchmarkInstantiateCycles(uint32_t arena_size) {
+    const int CYCLES = 1000;
+
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!engine) {
+        hardware.PrintLine("ERROR: Failed to create benchmark engine");
+        return;
+    }
+    if (!wamr_aot_engine_set_arena(engine, arena_size)) {
+        wamr_aot_engine_delete(engine);
+        return;
+    }
+
+    float total_us = 0.0f;
+    float max_us = 0.0f;
+    for (int i = 0; i < CYCLES; i++) {
+        Timer timer;
+        timer.start();
+        bool ok = wamr_aot_engine_load_embedded_module(engine);
+        wamr_aot_engine_unload_module(engine);
+        timer.end();
+        if (!ok) {
+            hardware.PrintLine("ERROR: Load failed on cycle %d", i);
+            break;
+        }
+        float elapsed_us = timer.usElapsed();
+        total_us += elapsed_us;
+        if (elapsed_us > max_us) max_us = elapsed_us;
+    }
+    wamr_aot_engine_delete(engine);
+
+    // Hand cached and queued blocks back to the core first, or they would show up
+    // as fragmentation in its free list
+    wamr_sdram_cache_flush();
+    wamr_sdram_cache_maintain();
+    unsigned int free_blocks, largest_free, total_free;
+    sdram.getFreeStats(free_blocks, largest_free, total_free);
+
+    hardware.PrintLine("%s: %d cycles", arena_size ? "Arena" : "SDRAM heap", CYCLES);
+    hardware.PrintLine("  Cycle avg: " FLT_FMT3 " us, max: " FLT_FMT3 " us", FLT_VAR3(total_us / CYCLES), FLT_VAR3(max_us));
+    hardware.PrintLine("  SDRAM free blocks: %u, largest: %u of %u bytes free", free_blocks, largest_free, total_free);
+}
+#endif
+
+#ifdef BENCH_EVENTS
+/**
+ * Compare delivering one event every EVENT_SPACING samples through the event ring
+ * (one process() call per block) against splitting the block at each event
+ */
+void BenchmarkEventDelivery() {
+    const int BLOCKS = 100;
+    const int EVENT_SPACING = 8;
+    float input_buffer[BLOCK_SIZE] = {};
+    float output_buffer[BLOCK_SIZE];
+
+    float ring_us = 0.0f;
+    for (int b = 0; b < BLOCKS; b++) {
+        Timer timer;
+        timer.start();
+        uint32_t block_time = wamr_aot_engine_sample_time(wamr_engine);
+        for (int offset = 0; offset < BLOCK_SIZE; offset += EVENT_SPACING) {
+            wamr_aot_engine_push_event(wamr_engine, block_time + offset, 1, 500.f + offset, 0);
+        }
+        wamr_aot_engine_process(wamr_engine, input_buffer, output_buffer, BLOCK_SIZE);
+        timer.end();
+        ring_us += timer.usElapsed();
+    }
+
+    float split_us = 0.0f;
+    for (int b = 0; b < BLOCKS; b++) {
+        Timer timer;
+        timer.start();
+        for (int offset = 0; offset < BLOCK_SIZE; offset += EVENT_SPACING) {
+            wamr_aot_engine_process(wamr_engine, input_buffer + offset, output_buffer + offset, EVENT_SPACING);
+        }
+        timer.end();
+        split_us += timer.usElapsed();
+    }
+
+    hardware.PrintLine("%d events/block over %d blocks", BLOCK_SIZE / EVENT_SPACING, BLOCKS);
+    hardware.PrintLine("  Event ring:     " FLT_FMT3 " us/block", FLT_VAR3(ring_us / BLOCKS));
+    hardware.PrintLine("  Block splitting: " FLT_FMT3 " us/block", FLT_VAR3(split_us / BLOCKS));
+    hardware.PrintLine("  Dropped events: %u", (unsigned)wamr_engine->events_dropped);
+}
+#endif
+
+#ifdef WAMR_POOL_SIZE
+/**
+ * Load extra instances of the embedded module until the static pool runs out,
+ * then release them. Exhaustion must fail the load cleanly, never the device.
+ */
+void ProbePoolExhaustion() {
+    const int MAX_ENGINES = 32;
+    WamrAotEngine* engines[MAX_ENGINES];
+    int loaded = 0;
+    while (loaded < MAX_ENGINES) {
+        WamrAotEngine* engine = wamr_aot_engine_new();
+        if (!engine) break;
+        if (!wamr_aot_engine_load_embedded_module(engine)) {
+            wamr_aot_engine_delete(engine);
+            break;
+        }
+        engines[loaded++] = engine;
+    }
+
+    WamrPoolInfo pool;
+    wamr_aot_runtime_pool_info(&pool);
+    for (int i = 0; i < loaded; i++) {
+        wamr_aot_engine_delete(engines[i]);
+    }
 
-    // Copy left channel to right channel for stereo output
-    memcpy(out[1], out[0], size * sizeof(float));
+    hardware.PrintLine("Extra instances before exhaustion: %d%s", loaded, loaded == MAX_ENGINES ? " (limit)" : "");
+    hardware.PrintLine("  Pool high-water: %u of %u bytes", (unsigned)pool.high_water, (unsigned)pool.size);
+    hardware.PrintLine("  Pool in use after release: %u bytes", (unsigned)wamr_aot_runtime_bytes_in_use());
 }
+#endif
+
+#ifdef BENCH_REBLOCK
+/**
+ * Per-host-block cost of the embedded module run through the stream at
+ * 1/rate_divisor of the host rate (0 = the module's own preference), and the
+ * pitch of its 1 kHz ramp measured at the host rate, which must not depend on
+ * the internal rate
+ */
+float AverageStreamBlockUs(int rate_divisor, int* latency, float* pitch_hz) {
+    const int RUNS = 200;
+    const int PITCH_BLOCKS = 375; // 1 s at 128 samples / 48 kHz
+    *latency = -1;
+    *pitch_hz = 0.0f;
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!engine || !wamr_aot_engine_load_embedded_module(engine)) {
+        hardware.PrintLine("ERROR: Failed to load benchmark engine");
+        wamr_aot_engine_delete(engine);
+        return 0.0f;
+    }
+    *latency = wamr_aot_engine_set_stream(engine, BLOCK_SIZE, 0, rate_divisor);
+    if (*latency < 0) {
+        hardware.PrintLine("ERROR: Failed to set up the stream");
+        wamr_aot_engine_delete(engine);
+        return 0.0f;
+    }
+
+    float input_buffer[BLOCK_SIZE];
+    float output_buffer[BLOCK_SIZE];
+    for (int j = 0; j < BLOCK_SIZE; j++) {
+        input_buffer[j] = daisy::Random::GetFloat(-1.f, 1.f);
+    }
+    float total_us = 0.0f;
+    for (int i = 0; i < RUNS; i++) {
+        Timer timer;
+        timer.start();
+        wamr_aot_engine_process(engine, input_buffer, output_buffer, BLOCK_SIZE);
+        timer.end();
+        total_us += timer.usElapsed();
+    }
+
+    // The ramp rises through 0.5 once per cycle, well away from its band-limited
+    // and resampled reset
+    int cycles = 0;
+    float previous = output_buffer[BLOCK_SIZE - 1];
+    for (int b = 0; b < PITCH_BLOCKS; b++) {
+        wamr_aot_engine_process(engine, input_buffer, output_buffer, BLOCK_SIZE);
+        for (int j = 0; j < BLOCK_SIZE; j++) {
+            if (previous < 0.5f && output_buffer[j] >= 0.5f) cycles++;
+            previous = output_buffer[j];
+        }
+    }
+    *pitch_hz = cycles * 48000.0f / (PITCH_BLOCKS * BLOCK_SIZE);
+
+    wamr_aot_engine_delete(engine);
+    return total_us / RUNS;
+}
+
+void BenchmarkInternalRate() {
+    int full_latency, half_latency, module_latency;
+    float full_pitch, half_pitch, module_pitch;
+    float full_us = AverageStreamBlockUs(1, &full_latency, &full_pitch);
+    float half_us = AverageStreamBlockUs(2, &half_latency, &half_pitch);
+    float module_us = AverageStreamBlockUs(0, &module_latency, &module_pitch);
+
+    hardware.PrintLine("48 kHz direct:     " FLT_FMT3 " us/block, latency %d samples, pitch " FLT_FMT3 " Hz",
+                       FLT_VAR3(full_us), full_latency, FLT_VAR3(full_pitch));
+    hardware.PrintLine("24 kHz resampled:  " FLT_FMT3 " us/block, latency %d samples, pitch " FLT_FMT3 " Hz",
+                       FLT_VAR3(half_us), half_latency, FLT_VAR3(half_pitch));
+    hardware.PrintLine("Module preference: " FLT_FMT3 " us/block, latency %d samples, pitch " FLT_FMT3 " Hz",
+                       FLT_VAR3(module_us), module_latency, FLT_VAR3(module_pitch));
+    hardware.PrintLine("CPU saved:         " FLT_FMT3 " %%", FLT_VAR3(100.0f * (full_us - half_us) / full_us));
+    if (fabsf(half_pitch - full_pitch) > 10.0f || fabsf(module_pitch - full_pitch) > 10.0f) {
+        hardware.PrintLine("ERROR: Pitch depends on the internal rate");
+    }
+}
+#endif
+
+#ifdef BENCH_ASSETS
+/**
+ * Share one asset of up to 32 MB between 8 instances, each streaming its own
+ * region block by block into its linear memory through the module's asset_read
+ * import, and report memory use and throughput
+ */
+void BenchmarkSharedAsset() {
+    const int INSTANCES = 8;
+    const uint32_t MAX_ASSET_SIZE = 32 * 1024 * 1024;
+    const uint32_t MIN_ASSET_SIZE = 4 * 1024 * 1024;
+    const int BLOCKS = 1000;
+    const uint32_t SLICE_BYTES = BLOCK_SIZE * sizeof(float);
+
+    // Instances first: the asset then takes what the 64 MB of SDRAM has left
+    uint32_t runtime_before = wamr_aot_runtime_bytes_in_use();
+    WamrAotEngine* engines[INSTANCES] = {};
+    wasm_function_inst_t read_funcs[INSTANCES] = {};
+    int loaded = 0;
+    for (; loaded < INSTANCES; loaded++) {
+        WamrAotEngine* engine = wamr_aot_engine_new();
+        if (!engine || !wamr_aot_engine_load_embedded_module(engine)) {
+            wamr_aot_engine_delete(engine);
+            break;
+        }
+        engines[loaded] = engine;
+        read_funcs[loaded] = wasm_runtime_lookup_function(engine->instance, "read_asset_block");
+        if (!read_funcs[loaded]) {
+            hardware.PrintLine("ERROR: Module has no read_asset_block export");
+            wamr_aot_engine_delete(engine);
+            break;
+        }
+    }
+    uint32_t runtime_bytes = wamr_aot_runtime_bytes_in_use() - runtime_before;
+
+    uint32_t asset_size = MAX_ASSET_SIZE;
+    float* samples = NULL;
+    while (asset_size >= MIN_ASSET_SIZE && !(samples = (float*)sdram_alloc(asset_size))) {
+        asset_size /= 2;
+    }
+    if (loaded == 0 || !samples) {
+        hardware.PrintLine("ERROR: %s", loaded == 0 ? "No benchmark instance loaded" : "Failed to allocate benchmark asset");
+        for (int i = 0; i < loaded; i++) wamr_aot_engine_delete(engines[i]);
+        if (samples) sdram_dealloc(samples);
+        return;
+    }
+    const uint32_t asset_floats = asset_size / sizeof(float);
+    for (uint32_t i = 0; i < asset_floats; i++) {
+        samples[i] = (float)(i & 0xFFFF) / 65536.0f;
+    }
+    int handle = wamr_asset_add("bench", samples, asset_size);
+
+    // Each instance streams its own region, wrapping if the asset came out small
+    const uint32_t region_floats = asset_floats / loaded;
+    Timer timer;
+    timer.start();
+    int mismatches = 0;
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int i = 0; i < loaded; i++) {
+            uint32_t index = i * region_floats + (b * BLOCK_SIZE) % (region_floats - BLOCK_SIZE);
+            uint32_t argv[3] = {(uint32_t)handle, index, BLOCK_SIZE};
+            float first = 0.0f;
+            if (wasm_runtime_call_wasm(engines[i]->exec_env, read_funcs[i], 3, argv)) {
+                memcpy(&first, argv, sizeof(first));
+            }
+            if (first != samples[index]) mismatches++;
+        }
+    }
+    timer.end();
+    float elapsed_us = timer.usElapsed();
+
+    for (int i = 0; i < loaded; i++) {
+        wamr_aot_engine_delete(engines[i]);
+    }
+    wamr_asset_remove(handle);
+    sdram_dealloc(samples);
+
+    float megabytes = (float)loaded * BLOCKS * SLICE_BYTES / (1024.0f * 1024.0f);
+    hardware.PrintLine("%d instances sharing a %u MB asset", loaded, (unsigned)(asset_size >> 20));
+    hardware.PrintLine("  Memory: %u MB asset + %u KB runtime (per-instance copies: %u MB)",
+                       (unsigned)(asset_size >> 20), (unsigned)(runtime_bytes >> 10),
+                       (unsigned)(((uint64_t)loaded * asset_size) >> 20));
+    hardware.PrintLine("  Slice reads: " FLT_FMT3 " us per %u-byte block, through the import",
+                       FLT_VAR3(elapsed_us / (loaded * BLOCKS)), (unsigned)SLICE_BYTES);
+    hardware.PrintLine("  Throughput:  " FLT_FMT3 " MB/s", FLT_VAR3(megabytes / (elapsed_us / 1e6f)));
+    if (mismatches) hardware.PrintLine("ERROR: %d blocks read back wrong", mismatches);
+}
+#endif
+
+#ifdef BENCH_FRAMES
+/**
+ * Per-block cost of the module's spectral frame mode, with each frame processed
+ * in the block it becomes ready (naive) or spread over the blocks of one hop
+ */
+void BenchmarkFrameMode(bool spread) {
+    const int BLOCKS = 512;
+    WamrAotEngine* engine = wamr_aot_engine_new();
+    if (!engine || !wamr_aot_engine_load_embedded_module(engine)) {
+        hardware.PrintLine("ERROR: Failed to load benchmark engine");
+        wamr_aot_engine_delete(engine);
+        return;
+    }
+    int latency = wamr_aot_engine_set_frames(engine, BLOCK_SIZE, spread);
+    if (latency < 0) {
+        wamr_aot_engine_delete(engine);
+        return;
+    }
+
+    float input_buffer[BLOCK_SIZE];
+    float output_buffer[BLOCK_SIZE];
+    float total_us = 0.0f;
+    float max_us = 0.0f;
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int j = 0; j < BLOCK_SIZE; j++) {
+            input_buffer[j] = daisy::Random::GetFloat(-1.f, 1.f);
+        }
+        Timer timer;
+        timer.start();
+        wamr_aot_engine_process(engine, input_buffer, output_buffer, BLOCK_SIZE);
+        timer.end();
+        float elapsed_us = timer.usElapsed();
+        total_us += elapsed_us;
+        if (elapsed_us > max_us) max_us = elapsed_us;
+    }
+
+    hardware.PrintLine("%s: %d slice(s)/frame, latency %d samples", spread ? "Spread" : "Naive ",
+                       engine->frame_slices, latency);
+    hardware.PrintLine("  Block avg: " FLT_FMT3 " us, worst: " FLT_FMT3 " us", FLT_VAR3(total_us / BLOCKS), FLT_VAR3(max_us));
+    wamr_aot_engine_delete(engine);
+}
+#endif
+
+#ifdef WAMR_TRUSTED_MODULES
+/**
+ * Compare per-block time of the trusted (unchecked) module against the same
+ * module compiled with software bounds checks
+ */
+float AverageBlockUs(WamrAotEngine* engine, int runs) {
+    float input_buffer[BLOCK_SIZE];
+    float output_buffer[BLOCK_SIZE];
+    for (int j = 0; j < BLOCK_SIZE; j++) {
+        input_buffer[j] = daisy::Random::GetFloat(-1.f, 1.f);
+    }
+    float total_us = 0.0f;
+    for (int i = 0; i < runs; i++) {
+        Timer timer;
+        timer.start();
+        wamr_aot_engine_process(engine, input_buffer, output_buffer, BLOCK_SIZE);
+        timer.end();
+        total_us += timer.usElapsed();
+    }
+    return total_us / runs;
+}
+
+void BenchmarkTrustedModule() {
+    const int RUNS = 100;
+    WamrAotEngine* checked = wamr_aot_engine_new();
+    if (!checked || !wamr_aot_engine_load_embedded_checked_module(checked)) {
+        hardware.PrintLine("ERROR: Failed to load bounds-checked module");
+        wamr_aot_engine_delete(checked);
+        return;
+    }
+    float checked_us = AverageBlockUs(checked, RUNS);
+    float trusted_us = AverageBlockUs(wamr_engine, RUNS);
+    wamr_aot_engine_delete(checked);
+
+    hardware.PrintLine("Bounds-checked: " FLT_FMT3 " us/block", FLT_VAR3(checked_us));
+    hardware.PrintLine("Trusted:        " FLT_FMT3 " us/block", FLT_VAR3(trusted_us));
+    hardware.PrintLine("Speedup:        " FLT_FMT3 "x", FLT_VAR3(checked_us / trusted_us));
+}
+#endif
 
 int main() {
     hardware.Init();
@@ -171,6 +592,7 @@ int main() {
     // Initialize SDRAM allocator
     hardware.PrintLine("Initializing SDRAM allocator...");
     sdram.init();
+    wamr_sdram_cache_init(SdramCoreAlloc, SdramCoreFree);
     hardware.PrintLine("SDRAM initialized (64MB at 0xC0000000)");
     hardware.PrintLine("");
     
@@ -269,6 +691,9 @@ int main() {
     float avg_us = total_us / BENCHMARK_RUNS;
     float avg_ticks = total_ticks / BENCHMARK_RUNS;
     
+    // Print what the engine logged from the process path so far
+    wamr_log_drain(PrintLineSink, nullptr);
+
     hardware.PrintLine("");
     hardware.PrintLine("=== BENCHMARK RESULTS ===");
     hardware.PrintLine("Iterations: %d", BENCHMARK_RUNS);
@@ -294,6 +719,99 @@ int main() {
         hardware.PrintLine("Result: Too slow for real-time X");
     }
     
+    // Per-entry-point timing gathered by the engine's scheduler
+    hardware.PrintLine("");
+    hardware.PrintLine("=== ENTRY POINT TIMING ===");
+    const char* entry_names[WAMR_ENTRY_COUNT] = {"process", "control_tick", "idle", "process_frame", "set_quality"};
+    for (int e = 0; e < WAMR_ENTRY_COUNT; e++) {
+        const WamrEntryStats* stats = wamr_aot_engine_get_entry_stats(wamr_engine, (WamrEntryPoint)e);
+        if (stats->calls == 0) continue;
+        hardware.PrintLine("%-12s calls: %u  avg: %u us  max: %u us  errors: %u", entry_names[e], (unsigned)stats->calls,
+                           (unsigned)(stats->total_us / stats->calls), (unsigned)stats->max_us, (unsigned)stats->errors);
+    }
+
+    // Memory actually used by the module vs what its instance was sized with
+    WamrMemoryProfile mem_profile;
+    wamr_aot_engine_get_memory_profile(wamr_engine, &mem_profile);
+    hardware.PrintLine("");
+    hardware.PrintLine("=== MEMORY PROFILE ===");
+    hardware.PrintLine("Static: %u bytes (data + BSS, zeroed at instantiation)", (unsigned)mem_profile.static_size);
+    hardware.PrintLine("Stack: %u used / %u reserved", (unsigned)mem_profile.stack_used, (unsigned)mem_profile.stack_size);
+    hardware.PrintLine("Heap:  %u peak / %u reserved", (unsigned)mem_profile.heap_peak, (unsigned)mem_profile.heap_size);
+    hardware.PrintLine("Linear memory: %u bytes", (unsigned)mem_profile.linear_memory);
+    hardware.PrintLine("Saved vs fixed sizing: %d bytes%s",
+                       (int)mem_profile.legacy_size - (int)(mem_profile.stack_size + mem_profile.heap_size),
+                       mem_profile.profiled ? "" : " (module not profiled yet)");
+
+    // Where the runtime's own allocations come from and what startup cost
+    hardware.PrintLine("");
+    hardware.PrintLine("=== RUNTIME MEMORY ===");
+    WamrPoolInfo pool;
+    if (wamr_aot_runtime_pool_info(&pool)) {
+        hardware.PrintLine("Mode: static pool (%u bytes)", (unsigned)pool.size);
+        hardware.PrintLine("Pool: %u used, %u high-water", (unsigned)pool.used, (unsigned)pool.high_water);
+    } else {
+        hardware.PrintLine("Mode: SDRAM allocator hooks");
+        hardware.PrintLine("In use: %u bytes", (unsigned)wamr_aot_runtime_bytes_in_use());
+    }
+    hardware.PrintLine("Boot:        " FLT_FMT3 " us", FLT_VAR3(boot_us));
+    hardware.PrintLine("Instantiate: " FLT_FMT3 " us", FLT_VAR3(instantiate_us));
+#ifdef WAMR_POOL_SIZE
+    ProbePoolExhaustion();
+#endif
+#ifdef WAMR_PROFILE_MEMORY
+    hardware.PrintLine("Paste into wasm-module/module.profile:");
+    hardware.PrintLine("stack_used=%u", (unsigned)mem_profile.stack_used);
+    hardware.PrintLine("heap_peak=%u", (unsigned)mem_profile.heap_peak);
+#endif
+
+#ifdef WAMR_TRUSTED_MODULES
+    hardware.PrintLine("");
+    hardware.PrintLine("=== TRUSTED VS BOUNDS-CHECKED ===");
+    BenchmarkTrustedModule();
+#endif
+
+#ifdef BENCH_EVENTS
+    hardware.PrintLine("");
+    hardware.PrintLine("=== EVENT DELIVERY ===");
+    BenchmarkEventDelivery();
+#endif
+
+#ifdef BENCH_FRAMES
+    hardware.PrintLine("");
+    hardware.PrintLine("=== FRAME MODE ===");
+    BenchmarkFrameMode(false);
+    BenchmarkFrameMode(true);
+#endif
+
+#ifdef BENCH_ASSETS
+    hardware.PrintLine("");
+    hardware.PrintLine("=== SHARED ASSET ===");
+    BenchmarkSharedAsset();
+#endif
+
+#ifdef BENCH_REBLOCK
+    hardware.PrintLine("");
+    hardware.PrintLine("=== INTERNAL RATE ===");
+    BenchmarkInternalRate();
+#endif
+
+#if WASM_ENABLE_PERF_PROFILING
+    hardware.PrintLine("");
+    hardware.PrintLine("=== FUNCTION PROFILE (CSV) ===");
+    wamr_aot_engine_write_func_profile_csv(wamr_engine, PrintLineSink, nullptr);
+    hardware.PrintLine("");
+    hardware.PrintLine("=== MEMORY CONSUMPTION (CSV) ===");
+    wamr_aot_engine_write_mem_consumption_csv(wamr_engine, PrintLineSink, nullptr);
+#endif
+
+#ifdef BENCH_ARENA
+    hardware.PrintLine("");
+    hardware.PrintLine("=== INSTANTIATE/TEARDOWN CYCLES ===");
+    BenchmarkInstantiateCycles(0);
+    BenchmarkInstantiateCycles(32 * 1024 * 1024);
+#endif
+
     hardware.PrintLine("");
     hardware.PrintLine("[SUCCESS] WAMR AOT benchmark complete!");
 
@@ -306,9 +824,49 @@ int main() {
     System::ResetToBootloader(System::BootloaderMode::DAISY_INFINITE_TIMEOUT);
     #endif
 
+    // Honour the module's preferred block size and internal rate, if it declares any
+    int stream_latency = wamr_aot_engine_set_stream(wamr_engine, BLOCK_SIZE, 0, 0);
+    if (stream_latency < 0) {
+        hardware.PrintLine("ERROR: Failed to configure re-blocking");
+        ERROR_HALT
+    }
+    if (wamr_engine->stream_block) {
+        hardware.PrintLine("Re-blocking to %d samples, added latency: %d samples", wamr_engine->stream_block, stream_latency);
+    }
+
+    // Arm the deadline watchdog so an overrunning module can't stall the device
+    InitDeadlineTimer();
+    int module_block = wamr_engine->stream_block ? wamr_engine->stream_block : BLOCK_SIZE;
+    if (!wamr_aot_engine_set_deadline(wamr_engine, DEADLINE_US, WAMR_FALLBACK_LAST_GOOD, module_block)) {
+        hardware.PrintLine("ERROR: Failed to configure deadline watchdog");
+        ERROR_HALT
+    }
+
+    // Meter every block and let the module shed work as load rises
+    wamr_aot_engine_set_load_meter(wamr_engine, 48000, LOAD_DEGRADE_ABOVE, LOAD_RESTORE_BELOW);
+
     // Start Audio
     hardware.SetAudioBlockSize(BLOCK_SIZE); // number of samples handled per callback (buffer size)
 	hardware.SetAudioSampleRate(SaiHandle::Config::SampleRate::SAI_48KHZ); // sample rate
-    hardware.StartAudio(AudioCallback);
-    return 0;
+    wamr_audio_set_engine(wamr_engine);
+    hardware.StartAudio(wamr_audio_callback);
+
+    // Main loop: format and print whatever the audio path logged, replace an instance
+    // the watchdog had to abandon, and print the load once a second
+    bool recovery_failed = false;
+    for (uint32_t tick = 1;; tick++) {
+        wamr_log_drain(PrintLineSink, nullptr);
+        wamr_sdram_cache_maintain();
+        if (!recovery_failed && wamr_aot_engine_needs_recovery(wamr_engine)) {
+            recovery_failed = !wamr_aot_engine_recover(wamr_engine);
+            hardware.PrintLine(recovery_failed ? "ERROR: Failed to re-instantiate module, output stays muted"
+                                               : "Module re-instantiated after a terminated call");
+        }
+        if (tick % 20 == 0) {
+            const WamrLoadMeter* load = wamr_aot_engine_get_load(wamr_engine);
+            hardware.PrintLine("Load: " FLT_FMT3 "%% avg, " FLT_FMT3 "%% peak, quality %d",
+                               FLT_VAR3(load->smoothed * 100.0f), FLT_VAR3(load->peak * 100.0f), load->quality);
+        }
+        System::Delay(50);
+    }
 }
\ No newline at end of file
@@ -16,6 +16,8 @@ WAMR_BUILD_SIMD = 0
 WAMR_BUILD_MULTI_MODULE = 0
 WAMR_BUILD_SHARED_MEMORY = 0
 WAMR_BUILD_MINI_LOADER = 1
+WAMR_BUILD_THREAD_MGR = 1
+WAMR_BUILD_BULK_MEMORY = 1
 
 # WAMR Source Files
 WAMR_CORE_DIR = $(WAMR_ROOT_DIR)/core/iwasm
@@ -53,6 +55,11 @@ C_SOURCES += \
 	$(WAMR_PLATFORM_DIR)/daisy_time.c \
 	$(WAMR_SHARED_DIR)/platform/common/math/math.c
 
+# Thread manager: the AOT image is compiled with suspend-flag polling so the deadline
+# watchdog can stop a runaway call, and the loader only accepts such images with it
+C_SOURCES += \
+	$(WAMR_CORE_DIR)/libraries/thread-mgr/thread_manager.c
+
 # libc-builtin
 C_SOURCES += \
 	$(WAMR_CORE_DIR)/libraries/libc-builtin/libc_builtin_wrapper.c
@@ -77,13 +84,16 @@ C_INCLUDES += \
 	-I$(WAMR_CORE_DIR)/include \
 	-I$(WAMR_CORE_DIR)/common \
 	-I$(WAMR_CORE_DIR)/aot \
+	-I$(WAMR_CORE_DIR)/interpreter \
 	-I$(WAMR_SHARED_DIR)/include \
 	-I. \
 	-I$(WAMR_SHARED_DIR)/platform/include \
 	-I$(WAMR_PLATFORM_DIR) \
 	-I$(WAMR_SHARED_DIR)/mem-alloc \
 	-I$(WAMR_SHARED_DIR)/utils \
-	-Idaisy-wrapper
+	-I$(WAMR_CORE_DIR)/libraries/thread-mgr \
+	-Idaisy-wrapper \
+	-Iwasm-module/build
 
 # WAMR Configuration Defines
 C_DEFS += \
@@ -99,10 +109,50 @@ C_DEFS += \
 	-DWASM_ENABLE_LIBC_WASI=0 \
 	-DWASM_ENABLE_MULTI_MODULE=0 \
 	-DWASM_ENABLE_SHARED_MEMORY=0 \
+	-DWASM_ENABLE_THREAD_MGR=1 \
+	-DWASM_ENABLE_BULK_MEMORY=1 \
 	-DWASM_ENABLE_MINI_LOADER=1 \
+	-DWASM_ENABLE_LOAD_CUSTOM_SECTION=1 \
 	-DWASM_DISABLE_HW_BOUND_CHECK=1 \
 	-DWASM_DISABLE_STACK_HW_BOUND_CHECK=1 \
 	-DBH_PLATFORM_DAISY
 
+# Memory profiling build: a generous app heap and emscripten's default C stack,
+# prints the lines for the module's wasm-module/module.profile (make PROFILE_MEMORY=1)
+PROFILE_MEMORY ?= 0
+ifeq ($(PROFILE_MEMORY),1)
+C_DEFS += -DWAMR_PROFILE_MEMORY
+endif
+
+# Per-function performance and memory profiling build (make PERF_PROFILING=1).
+# The module must be built with PERF_PROFILING=1 ./build-wasm.sh to match.
+PERF_PROFILING ?= 0
+ifeq ($(PERF_PROFILING),1)
+C_DEFS += \
+	-DWASM_ENABLE_PERF_PROFILING=1 \
+	-DWASM_ENABLE_MEMORY_PROFILING=1 \
+	-DWASM_ENABLE_CUSTOM_NAME_SECTION=1
+endif
+
+# Trusted-module build: embeds the unchecked AOT from TRUSTED=1 ./build-wasm.sh and
+# lets the loader accept images tagged "wamr.trusted" (make TRUSTED_MODULES=1)
+TRUSTED_MODULES ?= 0
+ifeq ($(TRUSTED_MODULES),1)
+C_DEFS += -DWAMR_TRUSTED_MODULES
+endif
+
+# Print module load progress (tier, entry points, arena use) (make VERBOSE_LOAD=1)
+VERBOSE_LOAD ?= 0
+ifeq ($(VERBOSE_LOAD),1)
+C_DEFS += -DWAMR_VERBOSE_LOAD
+endif
+
+# Static pool mode: WAMR allocates only from a pool of WAMR_POOL_KB kilobytes reserved
+# at startup instead of the shared SDRAM heap (make WAMR_POOL_KB=24576). 0 = allocator hooks.
+WAMR_POOL_KB ?= 0
+ifneq ($(WAMR_POOL_KB),0)
+C_DEFS += -DWAMR_POOL_SIZE=\($(WAMR_POOL_KB)u*1024u\)
+endif
+
 # Additional compiler flags for WAMR
 CFLAGS += -Wno-unused-parameter -Wno-unused-variable
@@ -3,13 +3,19 @@ set -e
 
 WAMR_ROOT=../wasm-micro-runtime
 
+# Output directory and AOT target. The defaults build for the Daisy; the Linux host
+# build uses BUILD_DIR=<dir> AOT_TARGET=x86_64 AOT_TARGET_FLAGS= ./build-wasm.sh
+BUILD_DIR=${BUILD_DIR:-build}
+AOT_TARGET=${AOT_TARGET:-thumbv7em}
+AOT_TARGET_FLAGS=${AOT_TARGET_FLAGS-"--cpu=cortex-m7 --enable-builtin-intrinsics=i64.common,fp.common"}
+
 echo "Building WASM module..."
 
 # Clean old build artifacts
 rm -f module.wasm module.aot module_aot.h
 
 # Create build directory
-mkdir -p build
+mkdir -p $BUILD_DIR
 
 # Check for emcc
 if ! command -v emcc &> /dev/null; then
@@ -20,19 +26,75 @@ fi
 
 echo "Using emscripten: $(which emcc)"
 
+# Per-function profiling: keep function names and emit AOT profiling hooks
+EMCC_PROFILE_FLAGS=""
+WAMRC_PROFILE_FLAGS=""
+CUSTOM_SECTIONS="wamr.profile"
+if [ "$PERF_PROFILING" = "1" ]; then
+    echo "Building with per-function profiling"
+    EMCC_PROFILE_FLAGS="--profiling-funcs"
+    WAMRC_PROFILE_FLAGS="--enable-perf-profiling"
+    CUSTOM_SECTIONS="$CUSTOM_SECTIONS,name"
+fi
+
+# Memory layout: the C stack is sized from the measured high-water in the module's
+# profile plus 25% (the wrapper's margin), or emscripten's 64 KB default until it
+# has been profiled and while profiling. Linear memory only has to hold static
+# data and the stack; the runtime appends the app heap.
+MODULE_PROFILE=${MODULE_PROFILE:-module.profile}
+stack_used=0
+if [ -f "$MODULE_PROFILE" ]; then
+    . "./$MODULE_PROFILE"
+fi
+if [ "$stack_used" -gt 0 ] && [ "$PROFILE_MEMORY" != "1" ]; then
+    STACK_SIZE=$(( (stack_used * 125 / 100 + 15) & ~15 ))
+else
+    STACK_SIZE=65536
+fi
+INITIAL_MEMORY=${INITIAL_MEMORY:-262144}
+
+# Preferred block size (0 = any) and internal rate divisor, see wamr_aot_engine_set_stream()
+STREAM_FLAGS="-DMODULE_BLOCK_SIZE=${MODULE_BLOCK_SIZE:-0} -DMODULE_RATE_DIVISOR=${MODULE_RATE_DIVISOR:-1}"
+
+# Compile a WASM file to AOT: compile_aot <in.wasm> <out.aot> [custom sections] [wamrc flags...]
+# --enable-multi-thread makes the code poll the exec env's suspend flags at every
+# loop header and after every call, which is how the deadline watchdog stops it
+compile_aot() {
+    local in=$1 out=$2 sections=$3
+    shift 3
+    $WAMR_ROOT/wamr-compiler/build/wamrc \
+        --target=$AOT_TARGET \
+        $AOT_TARGET_FLAGS \
+        --size-level=3 \
+        --enable-multi-thread \
+        $WAMRC_PROFILE_FLAGS \
+        ${sections:+--emit-custom-sections=$sections} \
+        "$@" \
+        -o $out \
+        $in
+}
+
 # Compile C++ to WASM using emscripten
 echo "Step 1: Compiling C++ to WASM..."
 emcc \
     -O2 \
     -sSTANDALONE_WASM \
     -sEXPORTED_RUNTIME_METHODS=[] \
-    -sEXPORTED_FUNCTIONS=_process \
+    -sEXPORTED_FUNCTIONS=_init,_process,_control_tick,_event_ring,_preferred_block_size,_internal_rate_divisor,_set_sample_rate,_set_quality,_frame_config,_process_frame,_read_asset_block \
     -sERROR_ON_UNDEFINED_SYMBOLS=0 \
+    -sSTACK_SIZE=$STACK_SIZE \
+    -sINITIAL_MEMORY=$INITIAL_MEMORY \
+    -Wl,--export=__data_end \
     --no-entry \
-    -o build/module.wasm \
+    $EMCC_PROFILE_FLAGS \
+    $STREAM_FLAGS \
+    -o $BUILD_DIR/module.wasm \
     module.cpp
 
-echo "WASM module size: $(wc -c < build/module.wasm) bytes"
+# Static layout and measured profile, as the "wamr.profile" custom section
+python3 module_layout.py $BUILD_DIR/module.wasm $STACK_SIZE "$MODULE_PROFILE"
+
+echo "WASM module size: $(wc -c < $BUILD_DIR/module.wasm) bytes"
 
 # Check for wamrc
 if [ ! -f "$WAMR_ROOT/wamr-compiler/build/wamrc" ]; then
@@ -48,34 +110,50 @@ if [ ! -f "$WAMR_ROOT/wamr-compiler/build/wamrc" ]; then
         cd build
         echo "Building wamrc..."
         cmake ..
-        make -j$(sysctl -n hw.ncpu)
+        make -j$(nproc 2>/dev/null || sysctl -n hw.ncpu)
     fi
     popd > /dev/null
     echo "wamrc build complete!"
 fi
 
-# Compile WASM to AOT for Cortex-M7
-echo "Step 2: Compiling WASM to AOT..."
-$WAMR_ROOT/wamr-compiler/build/wamrc \
-    --target=thumbv7em \
-    --cpu=cortex-m7 \
-    --size-level=3 \
-    --enable-builtin-intrinsics=i64.common,fp.common \
-    -o build/module.aot \
-    build/module.wasm
+# Compile WASM to AOT
+echo "Step 2: Compiling WASM to AOT for $AOT_TARGET..."
+compile_aot $BUILD_DIR/module.wasm $BUILD_DIR/module.aot "$CUSTOM_SECTIONS"
+
+echo "AOT module size: $(wc -c < $BUILD_DIR/module.aot) bytes"
 
-echo "AOT module size: $(wc -c < build/module.aot) bytes"
+# Trusted variant: no software bounds checks, tagged with an empty "wamr.trusted"
+# custom section (id 0, size 13, name length 12) that the loader only accepts in
+# TRUSTED_MODULES builds. Only for in-house modules already validated with the checked build.
+if [ "$TRUSTED" = "1" ]; then
+    echo "Step 2b: Compiling trusted (unchecked) AOT..."
+    cp $BUILD_DIR/module.wasm $BUILD_DIR/module_trusted.wasm
+    printf '\000\015\014wamr.trusted' >> $BUILD_DIR/module_trusted.wasm
+    compile_aot $BUILD_DIR/module_trusted.wasm $BUILD_DIR/module_trusted.aot \
+        "${CUSTOM_SECTIONS:+$CUSTOM_SECTIONS,}wamr.trusted" --bounds-checks=0
+    echo "Trusted AOT module size: $(wc -c < $BUILD_DIR/module_trusted.aot) bytes"
+fi
 
 # Convert to C header using xxd
 echo "Step 3: Embedding AOT in C header..."
-xxd -i -n module_aot build/module.aot > build/module_aot.h
+xxd -i -n module_aot $BUILD_DIR/module.aot > $BUILD_DIR/module_aot.h
+# Bytecode too, for the interpreter and JIT tiers of a host build
+xxd -i -n module_wasm $BUILD_DIR/module.wasm > $BUILD_DIR/module_wasm.h
+if [ "$TRUSTED" = "1" ]; then
+    xxd -i -n module_trusted_aot $BUILD_DIR/module_trusted.aot > $BUILD_DIR/module_trusted_aot.h
+fi
 
 echo ""
 echo "================================"
 echo "Module build complete!"
 echo "================================"
 echo "Generated files:"
-echo "  - build/module.wasm ($(wc -c < build/module.wasm) bytes)"
-echo "  - build/module.aot ($(wc -c < build/module.aot) bytes)"
-echo "  - build/module_aot.h (embedded)"
+echo "  - $BUILD_DIR/module.wasm ($(wc -c < $BUILD_DIR/module.wasm) bytes)"
+echo "  - $BUILD_DIR/module.aot ($(wc -c < $BUILD_DIR/module.aot) bytes)"
+echo "  - $BUILD_DIR/module_aot.h (embedded)"
+echo "  - $BUILD_DIR/module_wasm.h (bytecode, host tiers)"
+if [ "$TRUSTED" = "1" ]; then
+    echo "  - $BUILD_DIR/module_trusted.aot ($(wc -c < $BUILD_DIR/module_trusted.aot) bytes, no bounds checks)"
+    echo "  - $BUILD_DIR/module_trusted_aot.h (embedded)"
+fi
 echo ""
@@ -1,8 +1,40 @@
+#include "wamr_events.h"
+#include "wamr_frames.h"
+#include "wamr_asset_imports.h"
+#include <math.h>
+
+// Block size and rate the host should run this module at (build-wasm.sh sets these)
+#ifndef MODULE_BLOCK_SIZE
+#define MODULE_BLOCK_SIZE 0   // any block size
+#endif
+#ifndef MODULE_RATE_DIVISOR
+#define MODULE_RATE_DIVISOR 1 // host rate / internal rate
+#endif
+
+// Frame mode: spectral lowpass on FRAME_SIZE-point FFTs every FRAME_HOP samples
+#define FRAME_SIZE 1024       // power of two
+#define FRAME_LOG2 10
+#define FRAME_HOP 256
+#define FRAME_CUTOFF_BIN (FRAME_SIZE / 8)
+
+// Event types understood by this module
+enum EventType : uint32_t {
+  EVENT_SET_FREQUENCY = 1, // value = frequency in Hz
+  EVENT_RESET_PHASE = 2,
+  EVENT_SET_CUTOFF = 3,    // value = highest FFT bin the frame-mode lowpass passes
+  EVENT_GLIDE_FREQUENCY = 4 // value = frequency in Hz, reached smoothly by control_tick()
+};
+
+// Fraction of the remaining distance a glide covers per control tick, and the
+// distance at which it lands on its target
+#define GLIDE_COEFF 0.25f
+#define GLIDE_SNAP_HZ 0.5f
+
 class Phasor {
 private:
   float phase = 0.f;
   float frequency = 220.f; // Default to A3
-  const float sampleRate = 48000.f;
+  float sampleRate = 48000.f / MODULE_RATE_DIVISOR; // until the host calls set_sample_rate()
   float phaseInc = 0.f;
 
 public:
@@ -11,26 +43,234 @@ public:
     phaseInc = frequency / sampleRate;
   }
 
+  float getFrequency() const {
+    return frequency;
+  }
+
+  void setSampleRate(float rate) {
+    sampleRate = rate;
+    setFrequency(frequency);
+  }
+
+  void reset() {
+    phase = 0.f;
+  }
+
   float process() {
     phase += phaseInc;
     if (phase >= 1.f)
       phase -= 1.f;
     return phase;
   }
+
+  // PolyBLEP residual for the reset at the current phase; subtracting half of it
+  // band-limits the 0..1 ramp's unit drop
+  float blep() const {
+    if (phase < phaseInc) {
+      float t = phase / phaseInc;
+      return t + t - t * t - 1.f;
+    }
+    if (phase > 1.f - phaseInc) {
+      float t = (phase - 1.f) / phaseInc;
+      return t * t + t + t + 1.f;
+    }
+    return 0.f;
+  }
 };
 
-// Buffer-based audio processing function
-// This is exported to the host and called with blocks of audio samples
-extern "C" void process(const float* input, float* output, int num_samples) {
+// Function-local static so construction is guarded (linear memory BSS is zeroed by the host)
+static Phasor& getPhasor() {
   static Phasor phasor;
-  static bool initialized = false;
-  if (!initialized) {
-    phasor.setFrequency(1000.f); // 1000 Hz LFO
-    initialized = true;
+  return phasor;
+}
+
+// Event ring the host pushes timestamped events into
+extern "C" WamrEventRing* event_ring() {
+  static WamrEventRing ring;
+  return &ring;
+}
+
+// Re-blocking preferences, read once by the host at load
+extern "C" int preferred_block_size() {
+  return MODULE_BLOCK_SIZE;
+}
+
+extern "C" int internal_rate_divisor() {
+  return MODULE_RATE_DIVISOR;
+}
+
+// The rate process() actually runs at, which the host may have chosen over the
+// preference above. Called after init() and whenever the host's stream changes.
+extern "C" void set_sample_rate(float rate) {
+  getPhasor().setSampleRate(rate);
+}
+
+// Quality level from the host's load meter: 0 = full quality, higher = shed work.
+// Level 0 band-limits the ramp; above it the cheaper naive ramp is played.
+static int quality = 0;
+
+extern "C" void set_quality(int level) {
+  quality = level;
+}
+
+// Shared asset streaming: copy count floats of a host asset, starting at float
+// index, into a block buffer in this module's memory through the asset_read
+// import. Returns the first sample so the host can check what arrived.
+#define ASSET_BLOCK_MAX 256
+static float asset_block[ASSET_BLOCK_MAX];
+
+extern "C" float read_asset_block(int32_t handle, uint32_t index, int count) {
+  if (count > ASSET_BLOCK_MAX)
+    count = ASSET_BLOCK_MAX;
+  wamr_asset_read_floats(handle, index, asset_block, count);
+  return asset_block[0];
+}
+
+// Spectral lowpass state: one complex FFT buffer and its twiddle table
+static float fft_re[FRAME_SIZE];
+static float fft_im[FRAME_SIZE];
+static float twiddle_cos[FRAME_SIZE / 2];
+static float twiddle_sin[FRAME_SIZE / 2];
+
+static int cutoff_bin = FRAME_CUTOFF_BIN;
+
+extern "C" WamrFrameConfig* frame_config() {
+  static WamrFrameConfig config = {FRAME_SIZE, FRAME_HOP, WAMR_WINDOW_HANN, 0};
+  return &config;
+}
+
+static void init_twiddles() {
+  for (int k = 0; k < FRAME_SIZE / 2; k++) {
+    twiddle_cos[k] = cosf(2.f * (float)M_PI * k / FRAME_SIZE);
+    twiddle_sin[k] = -sinf(2.f * (float)M_PI * k / FRAME_SIZE);
+  }
+}
+
+// Frequency a glide is heading for, 0 when none is in progress
+static float glide_target = 0.f;
+
+// Events reach both paths: process() applies them on their exact sample,
+// process_frame() once per frame
+static void apply_event(const WamrEvent& event) {
+  switch (event.type) {
+    case EVENT_SET_FREQUENCY:
+      glide_target = 0.f;
+      getPhasor().setFrequency(event.value);
+      break;
+    case EVENT_GLIDE_FREQUENCY: glide_target = event.value > 0.f ? event.value : 0.f; break;
+    case EVENT_RESET_PHASE: getPhasor().reset(); break;
+    case EVENT_SET_CUTOFF:
+      cutoff_bin = event.value < 0.f ? 0 : event.value > FRAME_SIZE / 2 ? FRAME_SIZE / 2 : (int)event.value;
+      break;
+  }
+}
+
+static void bit_reverse() {
+  for (int i = 1, j = 0; i < FRAME_SIZE; i++) {
+    int bit = FRAME_SIZE >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j |= bit;
+    if (i < j) {
+      float t = fft_re[i]; fft_re[i] = fft_re[j]; fft_re[j] = t;
+      t = fft_im[i]; fft_im[i] = fft_im[j]; fft_im[j] = t;
+    }
+  }
+}
+
+// One radix-2 butterfly stage (stage 0 pairs neighbours)
+static void fft_stage(int stage) {
+  int half = 1 << stage;
+  int step = FRAME_SIZE / (2 * half);
+  for (int start = 0; start < FRAME_SIZE; start += 2 * half) {
+    for (int k = 0; k < half; k++) {
+      int a = start + k, b = a + half;
+      float wr = twiddle_cos[k * step], wi = twiddle_sin[k * step];
+      float tr = fft_re[b] * wr - fft_im[b] * wi;
+      float ti = fft_re[b] * wi + fft_im[b] * wr;
+      fft_re[b] = fft_re[a] - tr; fft_im[b] = fft_im[a] - ti;
+      fft_re[a] += tr; fft_im[a] += ti;
+    }
+  }
+}
+
+// The frame's work in order: load, forward FFT stages, filter, inverse FFT
+// (conjugate trick) stages, unload. Each slice runs an even share of the units.
+enum { FRAME_UNITS = 2 * FRAME_LOG2 + 3 };
+
+static void frame_unit(int unit, const float* input, float* output) {
+  if (unit == 0) {
+    for (int i = 0; i < FRAME_SIZE; i++) { fft_re[i] = input[i]; fft_im[i] = 0.f; }
+    bit_reverse();
+  } else if (unit <= FRAME_LOG2) {
+    fft_stage(unit - 1);
+  } else if (unit == FRAME_LOG2 + 1) {
+    // Drop every bin above the cutoff (both halves of the spectrum), then conjugate
+    for (int k = 0; k < FRAME_SIZE; k++) {
+      bool pass = k <= cutoff_bin || k >= FRAME_SIZE - cutoff_bin;
+      fft_re[k] = pass ? fft_re[k] : 0.f;
+      fft_im[k] = pass ? -fft_im[k] : 0.f;
+    }
+    bit_reverse();
+  } else if (unit <= 2 * FRAME_LOG2 + 1) {
+    fft_stage(unit - FRAME_LOG2 - 2);
+  } else {
+    for (int i = 0; i < FRAME_SIZE; i++) output[i] = fft_re[i] / FRAME_SIZE;
+  }
+}
+
+extern "C" void process_frame(const float* input, float* output, int frame_size, int slice, int slices) {
+  // The host sets block_time to the frame's first sample; everything due by its
+  // end applies to the whole frame
+  if (slice == 0) {
+    wamr_render_with_events(*event_ring(), frame_size, [](int, int) {}, apply_event);
   }
+  int begin, end;
+  wamr_frame_slice_range(FRAME_UNITS, slice, slices, begin, end);
+  for (int unit = begin; unit < end; unit++) {
+    frame_unit(unit, input, output);
+  }
+}
 
-  // Process each sample in the buffer
-  for (int i = 0; i < num_samples; i++) {
-    output[i] = phasor.process();
+// One-time setup, called by the host right after instantiation (and again for a
+// replacement instance), before any other export and whatever the schedule is
+extern "C" void init() {
+  getPhasor().setFrequency(1000.f); // 1000 Hz LFO
+  init_twiddles();
+}
+
+// Control-rate entry point, called by the host every few blocks ahead of process()
+// Coefficient updates that needn't be sample-accurate live here, off the per-sample
+// path: a glide steps the frequency, and with it the phase increment's divide, once
+// per tick instead of once per sample
+extern "C" void control_tick() {
+  if (glide_target <= 0.f) return;
+  Phasor& phasor = getPhasor();
+  float distance = glide_target - phasor.getFrequency();
+  if (fabsf(distance) < GLIDE_SNAP_HZ) {
+    phasor.setFrequency(glide_target);
+    glide_target = 0.f;
+  } else {
+    phasor.setFrequency(phasor.getFrequency() + GLIDE_COEFF * distance);
   }
 }
+
+// Buffer-based audio processing function
+// This is exported to the host and called with blocks of audio samples
+extern "C" void process(const float* input, float* output, int num_samples) {
+  Phasor& phasor = getPhasor();
+
+  // Render between events so each one lands on its exact sample
+  wamr_render_with_events(*event_ring(), num_samples,
+    [&](int offset, int count) {
+      if (quality == 0) {
+        for (int i = offset; i < offset + count; i++) {
+          output[i] = phasor.process() - 0.5f * phasor.blep();
+        }
+      } else {
+        for (int i = offset; i < offset + count; i++) {
+          output[i] = phasor.process();
+        }
+      }
+    },
+    apply_event);
+}
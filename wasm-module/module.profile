@@ -0,0 +1,5 @@
+# Measured memory use of module.cpp, read by build-wasm.sh and module_layout.py.
+# Replace with the lines printed by a `make PROFILE_MEMORY=1` run or by the host
+# memory_report (0 = not profiled).
+stack_used=0
+heap_peak=0
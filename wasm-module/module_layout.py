@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Append a "wamr.profile" custom section to a linked module.
+
+    module_layout.py <module.wasm> <stack size> [module.profile]
+
+The section holds the module's static layout, read from the binary, and its
+measured stack and heap use from the optional profile file (stack_used=N and
+heap_peak=N lines, printed by a PROFILE_MEMORY build). The wrapper uses it to
+zero BSS, measure the C stack in linear memory and size the app heap; the
+struct is WamrModuleProfile in module_profile.h.
+"""
+import struct
+import sys
+
+SECTION_NAME = b"wamr.profile"
+PROFILE_VERSION = 1
+
+
+def uleb(buf, pos):
+    result = shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        result |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return result, pos
+
+
+def sleb(buf, pos):
+    result = shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        result |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            if byte & 0x40:
+                result -= 1 << shift
+            return result, pos
+
+
+def encode_uleb(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        out.append(byte | (0x80 if value else 0))
+        if not value:
+            return bytes(out)
+
+
+def const_expr(buf, pos):
+    """Value of an i32.const init expression (None otherwise) and the position after it."""
+    value = None
+    if buf[pos] == 0x41:
+        value, pos = sleb(buf, pos + 1)
+        value &= 0xFFFFFFFF
+    while buf[pos] != 0x0B:
+        pos += 1
+    return value, pos + 1
+
+
+def skip_limits(buf, pos):
+    flags = buf[pos]
+    _, pos = uleb(buf, pos + 1)
+    if flags & 1:
+        _, pos = uleb(buf, pos)
+    return pos
+
+
+def read_layout(wasm):
+    if wasm[:4] != b"\0asm":
+        raise ValueError("not a wasm module")
+    imported_globals = 0
+    globals_ = []  # (mutable, i32 init) of defined globals
+    exports = {}
+    segments = []  # (offset, length) of active data segments
+
+    pos = 8
+    while pos < len(wasm):
+        section_id = wasm[pos]
+        size, pos = uleb(wasm, pos + 1)
+        end = pos + size
+        if section_id in (2, 6, 7, 11):
+            count, p = uleb(wasm, pos)
+            for _ in range(count):
+                if section_id == 2:  # imports
+                    for _ in range(2):
+                        length, p = uleb(wasm, p)
+                        p += length
+                    kind = wasm[p]
+                    p += 1
+                    if kind == 0:
+                        _, p = uleb(wasm, p)
+                    elif kind == 1:
+                        p = skip_limits(wasm, p + 1)
+                    elif kind == 2:
+                        p = skip_limits(wasm, p)
+                    else:
+                        imported_globals += 1
+                        p += 2
+                elif section_id == 6:  # globals
+                    mutable = wasm[p + 1] == 1
+                    value, p = const_expr(wasm, p + 2)
+                    globals_.append((mutable, value))
+                elif section_id == 7:  # exports
+                    length, p = uleb(wasm, p)
+                    name = wasm[p:p + length].decode()
+                    kind = wasm[p + length]
+                    index, p = uleb(wasm, p + length + 1)
+                    if kind == 3:
+                        exports[name] = index
+                else:  # data
+                    flags, p = uleb(wasm, p)
+                    offset = None
+                    if flags == 2:
+                        _, p = uleb(wasm, p)
+                    if flags != 1:
+                        offset, p = const_expr(wasm, p)
+                    length, p = uleb(wasm, p)
+                    p += length
+                    if offset is not None:
+                        segments.append((offset, length))
+        pos = end
+
+    def global_value(index):
+        index -= imported_globals
+        return globals_[index][1] if 0 <= index < len(globals_) else None
+
+    if "__data_end" not in exports:
+        raise ValueError("__data_end is not exported (link with -Wl,--export=__data_end)")
+    static_end = global_value(exports["__data_end"])
+    # wasm-ld always makes the stack pointer the first defined global
+    if "__stack_pointer" in exports:
+        stack_end = global_value(exports["__stack_pointer"])
+    elif globals_ and globals_[0][0]:
+        stack_end = globals_[0][1]
+    else:
+        stack_end = None
+    if static_end is None or stack_end is None:
+        raise ValueError("can't find __data_end / __stack_pointer values")
+
+    data_begin = min((offset for offset, _ in segments), default=static_end)
+    # BSS isn't stored in the binary: it runs from the last initialized byte to __data_end
+    bss_begin = max((offset + length for offset, length in segments), default=data_begin)
+    return data_begin, min(bss_begin, static_end), static_end, stack_end
+
+
+def read_profile(path):
+    values = {"stack_used": 0, "heap_peak": 0}
+    if path:
+        try:
+            with open(path) as f:
+                for line in f:
+                    line = line.split("#", 1)[0].strip()
+                    if "=" in line:
+                        key, value = line.split("=", 1)
+                        if key.strip() in values:
+                            values[key.strip()] = int(value, 0)
+        except FileNotFoundError:
+            pass
+    return values["stack_used"], values["heap_peak"]
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        sys.exit(__doc__)
+    path, stack_size = sys.argv[1], int(sys.argv[2], 0)
+    with open(path, "rb") as f:
+        wasm = f.read()
+    data_begin, bss_begin, static_end, stack_end = read_layout(wasm)
+    stack_used, heap_peak = read_profile(sys.argv[3] if len(sys.argv) == 4 else None)
+
+    payload = struct.pack("<8I", PROFILE_VERSION, data_begin, bss_begin, static_end,
+                          max(stack_end - stack_size, 0), stack_end, stack_used, heap_peak)
+    body = encode_uleb(len(SECTION_NAME)) + SECTION_NAME + payload
+    with open(path, "ab") as f:
+        f.write(b"\0" + encode_uleb(len(body)) + body)
+    print("Layout: data 0x%x-0x%x, bss to 0x%x, stack 0x%x-0x%x, profile: stack %u, heap %u"
+          % (data_begin, bss_begin, static_end, max(stack_end - stack_size, 0), stack_end,
+             stack_used, heap_peak))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+
+// Per-module memory profile, carried by every module in a "wamr.profile" custom
+// section. build-wasm.sh appends it with module_layout.py: the static layout is
+// read from the linked binary, the measured use comes from the module's
+// module.profile file. Regenerate module.profile by building with
+// `make PROFILE_MEMORY=1`, running the benchmark and pasting the lines it prints.
+// Until a module has been profiled (stack_used 0) the wrapper uses the legacy sizes.
+
+#define WAMR_PROFILE_SECTION "wamr.profile"
+#define WAMR_PROFILE_VERSION 1
+
+// All addresses are linear memory offsets
+typedef struct {
+    uint32_t version;       // WAMR_PROFILE_VERSION
+    uint32_t data_begin;    // first byte of initialized data
+    uint32_t bss_begin;     // end of initialized data; zero-initialized up to static_end
+    uint32_t static_end;    // __data_end
+    uint32_t stack_begin;   // lowest address of the C stack
+    uint32_t stack_end;     // initial __stack_pointer, the stack grows down from here
+    uint32_t stack_used;    // measured C stack high-water, 0 until profiled
+    uint32_t heap_peak;     // measured app heap high-water, 0 until profiled
+} WamrModuleProfile;
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+// Module-side view of the host's shared read-only assets (daisy-wrapper/wamr_assets.h).
+// Assets stay in host SDRAM; asset_read() copies just the requested slice into a
+// buffer in this module's linear memory, so a module never has to hold a whole asset.
+
+#define WAMR_ASSET_IMPORT(name) __attribute__((import_module("env"), import_name(#name)))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Handle of the asset registered under name, or -1
+WAMR_ASSET_IMPORT(asset_find) int32_t asset_find(const char* name);
+
+// Size in bytes, or -1 for an unknown handle
+WAMR_ASSET_IMPORT(asset_size) int32_t asset_size(int32_t handle);
+
+// Copy up to len bytes from offset into dst; returns bytes copied (short at the end), or -1
+WAMR_ASSET_IMPORT(asset_read) int32_t asset_read(int32_t handle, uint32_t offset, void* dst, uint32_t len);
+
+#ifdef __cplusplus
+}
+
+// Read count floats starting at float index into dst, zero-filling past the end
+inline void wamr_asset_read_floats(int32_t handle, uint32_t index, float* dst, int count) {
+  int32_t bytes = asset_read(handle, index * sizeof(float), dst, count * sizeof(float));
+  for (int i = bytes < 0 ? 0 : bytes / (int)sizeof(float); i < count; i++) {
+    dst[i] = 0.f;
+  }
+}
+#endif
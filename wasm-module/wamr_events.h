@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+// Sample-accurate event ring shared between host and module.
+// The ring lives in the module's linear memory (the module exports event_ring()
+// returning its address). The host is the only writer of write_index and the
+// events, the module the only reader/writer of read_index, so no locks are needed.
+// Events must be pushed in non-decreasing time order.
+
+#define WAMR_EVENT_RING_CAPACITY 256  // power of two
+#define WAMR_EVENT_RING_MASK (WAMR_EVENT_RING_CAPACITY - 1)
+
+typedef struct {
+    uint32_t time;   // absolute sample time
+    uint32_t type;   // module-defined
+    float value;
+    uint32_t data;
+} WamrEvent;
+
+typedef struct {
+    uint32_t write_index;  // advanced by the host
+    uint32_t read_index;   // advanced by the module
+    uint32_t block_time;   // sample time of the current block's first sample, set by the host
+    uint32_t reserved;
+    WamrEvent events[WAMR_EVENT_RING_CAPACITY];
+} WamrEventRing;
+
+#ifdef __cplusplus
+/**
+ * Module-side helper: render a block of num_samples, split at the offsets of the
+ * events due in it. render(offset, count) renders a sub-range, handle(event)
+ * applies an event. Late events apply at the start of the block; events past the
+ * block stay queued.
+ */
+template <typename Render, typename Handle>
+void wamr_render_with_events(WamrEventRing& ring, int num_samples, Render render, Handle handle) {
+  int pos = 0;
+  uint32_t read = ring.read_index;
+  while (read != __atomic_load_n(&ring.write_index, __ATOMIC_ACQUIRE)) {
+    const WamrEvent& event = ring.events[read & WAMR_EVENT_RING_MASK];
+    int32_t offset = (int32_t)(event.time - ring.block_time);
+    if (offset >= num_samples) break;
+    if (offset > pos) {
+      render(pos, offset - pos);
+      pos = offset;
+    }
+    handle(event);
+    __atomic_store_n(&ring.read_index, ++read, __ATOMIC_RELEASE);
+  }
+  if (pos < num_samples) render(pos, num_samples - pos);
+}
+#endif
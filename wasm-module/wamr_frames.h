@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+// Frame-based (spectral) processing handled by the host. A module exports
+// frame_config() returning the address of a WamrFrameConfig in its linear memory
+// and process_frame(input, output, frame_size, slice, slices). The host keeps the
+// input history and the overlap-add accumulator, applies the windows, and hands
+// the module one frame every hop_size samples.
+//
+// To avoid a CPU spike on every hop, each frame may be processed over several
+// blocks: process_frame is then called `slices` times with slice = 0..slices-1,
+// on the same input and output buffers, and the output is read after the last
+// slice. A module that can't split its work does everything when slice == 0.
+
+typedef enum {
+    WAMR_WINDOW_RECT = 0,   // no windowing
+    WAMR_WINDOW_HANN,       // Hann analysis, no synthesis window
+    WAMR_WINDOW_SQRT_HANN   // square-root Hann on analysis and synthesis
+} WamrWindow;
+
+typedef struct {
+    uint32_t frame_size;
+    uint32_t hop_size;  // must divide frame_size so the windows overlap-add to a constant
+    uint32_t window;    // WamrWindow
+    uint32_t reserved;
+} WamrFrameConfig;
+
+#ifdef __cplusplus
+// Module-side helper: the [begin, end) share of `units` of work that belongs to this slice
+inline void wamr_frame_slice_range(int units, int slice, int slices, int& begin, int& end) {
+    begin = units * slice / slices;
+    end = units * (slice + 1) / slices;
+}
+#endif